@@ -164,7 +164,7 @@ void CraftInfoState::init()
 
 	std::ostringstream firlsLine;
 	firlsLine << tr("STR_DAMAGE_UC_").arg(Unicode::formatPercentage(_craft->getDamagePercentage()));
-	if (_craft->getStatus() == "STR_REPAIRS" && _craft->getDamage() > 0)
+	if (_craft->getStatus() == Craft::STATUS_REPAIRS && _craft->getDamage() > 0)
 	{
 		int damageHours = (int)ceil((double)_craft->getDamage() / _craft->getRules()->getRepairRate());
 		firlsLine << formatTime(damageHours);
@@ -173,7 +173,7 @@ void CraftInfoState::init()
 
 	std::ostringstream secondLine;
 	secondLine << tr("STR_FUEL").arg(Unicode::formatPercentage(_craft->getFuelPercentage()));
-	if (_craft->getStatus() == "STR_REFUELLING" && _craft->getRules()->getMaxFuel() - _craft->getFuel() > 0)
+	if (_craft->getStatus() == Craft::STATUS_REFUELLING && _craft->getRules()->getMaxFuel() - _craft->getFuel() > 0)
 	{
 		int fuelHours = (int)ceil((double)(_craft->getRules()->getMaxFuel() - _craft->getFuel()) / _craft->getRules()->getRefuelRate() / 2.0);
 		secondLine << formatTime(fuelHours);
@@ -235,7 +235,7 @@ void CraftInfoState::init()
 			leftWeaponLine.str("");
 			leftWeaponLine << tr("STR_AMMO_").arg(w1->getAmmo()) << "\n" << Unicode::TOK_COLOR_FLIP;
 			leftWeaponLine << tr("STR_MAX").arg(w1->getRules()->getAmmoMax());
-			if (_craft->getStatus() == "STR_REARMING" && w1->getAmmo() < w1->getRules()->getAmmoMax())
+			if (_craft->getStatus() == Craft::STATUS_REARMING && w1->getAmmo() < w1->getRules()->getAmmoMax())
 			{
 				int rearmHours = (int)ceil((double)(w1->getRules()->getAmmoMax() - w1->getAmmo()) / w1->getRules()->getRearmRate());
 				leftWeaponLine << formatTime(rearmHours);
@@ -274,7 +274,7 @@ void CraftInfoState::init()
 			rightWeaponLine.str("");
 			rightWeaponLine << tr("STR_AMMO_").arg(w2->getAmmo()) << "\n" << Unicode::TOK_COLOR_FLIP;
 			rightWeaponLine << tr("STR_MAX").arg(w2->getRules()->getAmmoMax());
-			if (_craft->getStatus() == "STR_REARMING" && w2->getAmmo() < w2->getRules()->getAmmoMax())
+			if (_craft->getStatus() == Craft::STATUS_REARMING && w2->getAmmo() < w2->getRules()->getAmmoMax())
 			{
 				int rearmHours = (int)ceil((double)(w2->getRules()->getAmmoMax() - w2->getAmmo()) / w2->getRules()->getRearmRate());
 				rightWeaponLine << formatTime(rearmHours);
@@ -444,7 +444,7 @@ void CraftSoldiersState::lstSoldiersClick(Action *action)
 			s->setCraft(0);
 			_lstSoldiers->setCellText(row, 2, tr("STR_NONE_UC"));
 		}
-		else if (s->getCraft() && s->getCraft()->getStatus() == "STR_OUT")
+		else if (s->getCraft() && s->getCraft()->getStatus() == Craft::STATUS_OUT)
 		{
 			color = _otherCraftColor;
 		}
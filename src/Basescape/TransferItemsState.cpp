@@ -153,7 +153,7 @@ TransferItemsState::TransferItemsState(Base *baseFrom, Base *baseTo) : _baseFrom
 	}
 	for (std::vector<Craft*>::iterator i = _baseFrom->getCrafts()->begin(); i != _baseFrom->getCrafts()->end(); ++i)
 	{
-		if ((*i)->getStatus() != "STR_OUT" || (Options::canTransferCraftsWhileAirborne && (*i)->getFuel() >= (*i)->getFuelLimit(_baseTo)))
+		if ((*i)->getStatus() != Craft::STATUS_OUT || (Options::canTransferCraftsWhileAirborne && (*i)->getFuel() >= (*i)->getFuelLimit(_baseTo)))
 		{
 			TransferRow row = { TRANSFER_CRAFT, (*i), (*i)->getName(_game->getLanguage()), (int)(25 * _distance), 1, 0, 0 };
 			_items.push_back(row);
@@ -359,7 +359,7 @@ void TransferItemsState::completeTransfer()
 					if ((*s)->getCraft() == craft)
 					{
 						(*s)->setPsiTraining(false);
-						if (craft->getStatus() == "STR_OUT")
+						if (craft->getStatus() == Craft::STATUS_OUT)
 						{
 							_baseTo->getSoldiers()->push_back(*s);
 						}
@@ -379,7 +379,7 @@ void TransferItemsState::completeTransfer()
 
 				// Transfer craft
 				_baseFrom->removeCraft(craft, false);
-				if (craft->getStatus() == "STR_OUT")
+				if (craft->getStatus() == Craft::STATUS_OUT)
 				{
 					bool returning = (craft->getDestination() == (Target*)craft->getBase());
 					_baseTo->getCrafts()->push_back(craft);
@@ -617,7 +617,7 @@ void TransferItemsState::increaseByValue(int change)
 			_pQty += craft->getNumSoldiers();
 			_iQty += craft->getItems()->getTotalSize(_game->getMod());
 			getRow().amount++;
-			if (!Options::canTransferCraftsWhileAirborne || craft->getStatus() != "STR_OUT")
+			if (!Options::canTransferCraftsWhileAirborne || craft->getStatus() != Craft::STATUS_OUT)
 				_total += getRow().cost;
 			break;
 		case TRANSFER_ITEM:
@@ -701,7 +701,7 @@ void TransferItemsState::decreaseByValue(int change)
 		break;
 	}
 	getRow().amount -= change;
-	if (!Options::canTransferCraftsWhileAirborne || 0 == craft || craft->getStatus() != "STR_OUT")
+	if (!Options::canTransferCraftsWhileAirborne || 0 == craft || craft->getStatus() != Craft::STATUS_OUT)
 		_total -= getRow().cost * change;
 	updateItemStrings();
 }
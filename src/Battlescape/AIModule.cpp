@@ -139,6 +139,7 @@ void AIModule::think(BattleAction *action)
 	action->type = BA_RETHINK;
 	action->actor = _unit;
 	action->weapon = _unit->getMainHandWeapon(false);
+	action->path.clear();
 	_attackAction->diff = _save->getBattleState()->getGame()->getSavedGame()->getDifficultyCoefficient();
 	_attackAction->actor = _unit;
 	_attackAction->weapon = action->weapon;
@@ -381,6 +382,11 @@ void AIModule::think(BattleAction *action)
 		{
 			_escapeTUs = 0;
 			_ambushTUs = 0;
+			// walk the way the target was scored, calculate() may pick another route
+			if (_save->getTile(action->target))
+			{
+				action->path = _reachable.getPath(_save->getTileIndex(action->target));
+			}
 		}
 		else
 		{
@@ -545,7 +551,9 @@ void AIModule::setupPatrol()
 			}
 		}
 
-		if (_toNode != 0)
+		// nodes we can reach this turn are known to have a path, only search for the others
+		// and our own tile, which is reachable but has no path to it
+		if (_toNode != 0 && (_toNode->getPosition() == _unit->getPosition() || !_reachable.isReachable(_save->getTileIndex(_toNode->getPosition()))))
 		{
 			_save->getPathfinding()->calculate(_unit, _toNode->getPosition());
 			if (_save->getPathfinding()->getStartDirection() == -1)
@@ -600,7 +608,7 @@ void AIModule::setupAmbush()
 			Position pos = (*i)->getPosition();
 			Tile *tile = _save->getTile(pos);
 			if (tile == 0 || _save->getTileEngine()->distance(pos, _unit->getPosition()) > 10 || pos.z != _unit->getPosition().z || tile->getDangerous() ||
-				std::find(_reachableWithAttack.begin(), _reachableWithAttack.end(), _save->getTileIndex(pos))  == _reachableWithAttack.end())
+				!_reachableWithAttack.isReachable(_save->getTileIndex(pos)))
 				continue; // just ignore unreachable tiles
 
 			if (_traceAI)
@@ -614,10 +622,9 @@ void AIModule::setupAmbush()
 			Position target;
 			if (!_save->getTileEngine()->canTargetUnit(&origin, tile, &target, _aggroTarget, false, _unit) && !getSpottingUnits(pos))
 			{
-				_save->getPathfinding()->calculate(_unit, pos);
-				int ambushTUs = _save->getPathfinding()->getTotalTUCost();
+				int ambushTUs = _reachableWithAttack.getTUCost(_save->getTileIndex(pos));
 				// make sure we can move here
-				if (_save->getPathfinding()->getStartDirection() != -1)
+				if (pos != _unit->getPosition())
 				{
 					int score = BASE_SYSTEMATIC_SUCCESS;
 					score -= ambushTUs;
@@ -890,7 +897,7 @@ void AIModule::setupEscape()
 		else
 		{
 			spotters = getSpottingUnits(_escapeAction->target);
-			if (std::find(_reachable.begin(), _reachable.end(), _save->getTileIndex(_escapeAction->target))  == _reachable.end())
+			if (!_reachable.isReachable(_save->getTileIndex(_escapeAction->target)))
 				continue; // just ignore unreachable tiles
 
 			if (_spottingEnemies || spotters)
@@ -924,25 +931,20 @@ void AIModule::setupEscape()
 
 		if (tile && score > bestTileScore)
 		{
-			// calculate TUs to tile; we could be getting this from findReachable() somehow but that would break something for sure...
-			_save->getPathfinding()->calculate(_unit, _escapeAction->target);
-			if (_escapeAction->target == _unit->getPosition() || _save->getPathfinding()->getStartDirection() != -1)
+			// TUs to tile come straight from findReachable(), every tile that got here is reachable
+			bestTileScore = score;
+			bestTile = _escapeAction->target;
+			_escapeTUs = _reachable.getTUCost(_save->getTileIndex(_escapeAction->target));
+			if (_escapeAction->target == _unit->getPosition())
 			{
-				bestTileScore = score;
-				bestTile = _escapeAction->target;
-				_escapeTUs = _save->getPathfinding()->getTotalTUCost();
-				if (_escapeAction->target == _unit->getPosition())
-				{
-					_escapeTUs = 1;
-				}
-				if (_traceAI)
-				{
-					tile->setMarkerColor(score < 0 ? 7 : (score < FAST_PASS_THRESHOLD/2 ? 10 : (score < FAST_PASS_THRESHOLD ? 4 : 5)));
-					tile->setPreview(10);
-					tile->setTUMarker(score);
-				}
+				_escapeTUs = 1;
+			}
+			if (_traceAI)
+			{
+				tile->setMarkerColor(score < 0 ? 7 : (score < FAST_PASS_THRESHOLD/2 ? 10 : (score < FAST_PASS_THRESHOLD ? 4 : 5)));
+				tile->setPreview(10);
+				tile->setTUMarker(score);
 			}
-			_save->getPathfinding()->abortPath();
 			if (bestTileScore > FAST_PASS_THRESHOLD) coverFound = true; // good enough, gogogo
 		}
 	}
@@ -1002,12 +1004,14 @@ int AIModule::getSpottingUnits(const Position& pos) const
 	// if we don't actually occupy the position being checked, we need to do a virtual LOF check.
 	bool checking = pos != _unit->getPosition();
 	int tally = 0;
-	for (std::vector<BattleUnit*>::const_iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+	std::vector<BattleUnit*> candidates;
+	_save->getUnitsInRange(pos, TileEngine::MAX_VIEW_DISTANCE, candidates, _unit->getFaction());
+	for (std::vector<BattleUnit*>::const_iterator i = candidates.begin(); i != candidates.end(); ++i)
 	{
 		if (validTarget(*i, false, false))
 		{
 			int dist = _save->getTileEngine()->distance(pos, (*i)->getPosition());
-			if (dist > 20) continue;
+			if (dist > TileEngine::MAX_VIEW_DISTANCE) continue;
 			Position originVoxel = _save->getTileEngine()->getSightOriginVoxel(*i);
 			originVoxel.z -= 2;
 			Position targetVoxel;
@@ -1041,7 +1045,11 @@ int AIModule::selectNearestTarget()
 	_closestDist= 100;
 	_aggroTarget = 0;
 	Position target;
-	for (std::vector<BattleUnit*>::const_iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+	// nothing beyond view distance can be visible; the extra tile covers a unit
+	// whose tile hasn't caught up with its position yet.
+	std::vector<BattleUnit*> candidates;
+	_save->getUnitsInRange(_unit->getPosition(), TileEngine::MAX_VIEW_DISTANCE + 1, candidates, _unit->getFaction());
+	for (std::vector<BattleUnit*>::const_iterator i = candidates.begin(); i != candidates.end(); ++i)
 	{
 		if (validTarget(*i, true, _unit->getFaction() == FACTION_HOSTILE) &&
 			_save->getTileEngine()->visible(_unit, (*i)->getTile()))
@@ -1153,7 +1161,7 @@ bool AIModule::selectPointNearTarget(BattleUnit *target, int maxTUs) const
 				if (x || y) // skip the unit itself
 				{
 					Position checkPath = target->getPosition() + Position (x, y, z);
-					if (_save->getTile(checkPath) == 0 || std::find(_reachable.begin(), _reachable.end(), _save->getTileIndex(checkPath))  == _reachable.end())
+					if (_save->getTile(checkPath) == 0 || !_reachable.isReachable(_save->getTileIndex(checkPath)))
 						continue;
 					int dir = _save->getTileEngine()->getDirectionTo(checkPath, target->getPosition());
 					bool valid = _save->getTileEngine()->validMeleeRange(checkPath, dir, _unit, target, 0);
@@ -1444,8 +1452,7 @@ bool AIModule::findFirePoint()
 	{
 		Position pos = _unit->getPosition() + *i;
 		Tile *tile = _save->getTile(pos);
-		if (tile == 0  ||
-			std::find(_reachableWithAttack.begin(), _reachableWithAttack.end(), _save->getTileIndex(pos))  == _reachableWithAttack.end())
+		if (tile == 0  || !_reachableWithAttack.isReachable(_save->getTileIndex(pos)))
 			continue;
 		int score = 0;
 		// i should really make a function for this
@@ -1455,12 +1462,11 @@ bool AIModule::findFirePoint()
 
 		if (_save->getTileEngine()->canTargetUnit(&origin, _aggroTarget->getTile(), &target, _unit, false))
 		{
-			_save->getPathfinding()->calculate(_unit, pos);
 			// can move here
-			if (_save->getPathfinding()->getStartDirection() != -1)
+			if (pos != _unit->getPosition())
 			{
 				score = BASE_SYSTEMATIC_SUCCESS - getSpottingUnits(pos) * 10;
-				score += _unit->getTimeUnits() - _save->getPathfinding()->getTotalTUCost();
+				score += _unit->getTimeUnits() - _reachableWithAttack.getTUCost(_save->getTileIndex(pos));
 				if (!_aggroTarget->checkViewSector(pos))
 				{
 					score += 10;
@@ -1554,7 +1560,9 @@ bool AIModule::explosiveEfficacy(Position targetPos, BattleUnit *attackingUnit,
 		++efficacy;
 	}
 
-	for (std::vector<BattleUnit*>::iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+	std::vector<BattleUnit*> candidates;
+	_save->getUnitsInRange(targetPos, radius, candidates);
+	for (std::vector<BattleUnit*>::iterator i = candidates.begin(); i != candidates.end(); ++i)
 	{
 			// don't grenade dead guys
 		if (!(*i)->isOut() &&
@@ -20,6 +20,7 @@
 #include <yaml-cpp/yaml.h>
 #include "BattlescapeGame.h"
 #include "Position.h"
+#include "PathfindingField.h"
 #include "../Savegame/BattleUnit.h"
 #include <vector>
 
@@ -50,7 +51,8 @@ private:
 	bool _traceAI, _didPsi;
 	int _AIMode, _intelligence, _closestDist;
 	Node *_fromNode, *_toNode;
-	std::vector<int> _reachable, _reachableWithAttack, _wasHitBy;
+	PathfindingField _reachable, _reachableWithAttack;
+	std::vector<int> _wasHitBy;
 	BattleActionType _reserve;
 	UnitFaction _targetFaction;
 public:
@@ -203,7 +203,7 @@ void BattlescapeGame::handleAI(BattleUnit *unit)
 
 	unit->setVisible(false);
 
-	_save->getTileEngine()->calculateFOV(unit->getPosition()); // might need this populate _visibleUnit for a newly-created alien
+	_save->getTileEngine()->calculateFOV(unit->getPosition(), 1, false); // might need this populate _visibleUnit for a newly-created alien
 		// it might also help chryssalids realize they've zombified someone and need to move on
 		// it should also hide units when they've killed the guy spotting them
 		// it's also for good luck
@@ -226,6 +226,8 @@ void BattlescapeGame::handleAI(BattleUnit *unit)
 	BattleAction action;
 	action.actor = unit;
 	action.number = _AIActionCounter;
+	// the AI asks for the same lines of fire over and over while deciding.
+	_save->getTileEngine()->beginLofCache();
 	unit->think(&action);
 
 	if (action.type == BA_RETHINK)
@@ -233,6 +235,7 @@ void BattlescapeGame::handleAI(BattleUnit *unit)
 		_parentState->debug("Rethink");
 		unit->think(&action);
 	}
+	_save->getTileEngine()->endLofCache();
 
 	_AIActionCounter = action.number;
 	BattleItem *weapon = unit->getMainHandWeapon();
@@ -257,7 +260,11 @@ void BattlescapeGame::handleAI(BattleUnit *unit)
 		ss << "Walking to " << action.target;
 		_parentState->debug(ss.str());
 
-		if (_save->getTile(action.target))
+		if (!action.path.empty())
+		{
+			_save->getPathfinding()->setPath(action.actor, action.path);
+		}
+		else if (_save->getTile(action.target))
 		{
 			_save->getPathfinding()->calculate(action.actor, action.target);//, _save->getTile(action.target)->getUnit());
 		}
@@ -47,6 +47,7 @@ struct BattleAction
 	BattleItem *weapon;
 	Position target;
 	std::list<Position> waypoints;
+	std::vector<int> path; // walk planned by the AI, reversed like Pathfinding::getPath()
 	int TU;
 	bool targeting;
 	int value;
@@ -1487,7 +1487,7 @@ void DebriefingState::prepareDebriefing()
 			// reequip crafts (only those on the base) after a base defense mission
 			for (std::vector<Craft*>::iterator c = base->getCrafts()->begin(); c != base->getCrafts()->end(); ++c)
 			{
-				if ((*c)->getStatus() != "STR_OUT")
+				if ((*c)->getStatus() != Craft::STATUS_OUT)
 					reequipCraft(base, *c, false);
 			}
 			// Clear base->getVehicles() objects, they aren't needed anymore.
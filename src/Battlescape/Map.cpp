@@ -47,6 +47,7 @@
 #include "../Interface/NumberText.h"
 #include "../Interface/Text.h"
 #include "../fmath.h"
+#include <climits>
 
 
 /*
@@ -65,6 +66,73 @@
 namespace OpenXcom
 {
 
+namespace
+{
+
+const int arrowBob[8] = {0,1,2,1,0,1,2,1};
+
+/// Starting value of render keys.
+const Uint64 KEY_SEED = 14695981039346656037ULL;
+
+/**
+ * Mixes a value into a render key.
+ * @param key Key to change.
+ * @param value Value to add.
+ */
+inline void mixKey(Uint64 &key, Uint64 value)
+{
+	key = (key ^ value) * 1099511628211ULL;
+}
+
+/**
+ * Checks if an area of the screen has no pixels.
+ * @param area Area to check.
+ * @return True if it's empty.
+ */
+inline bool isEmptyArea(const GraphSubset &area)
+{
+	return area.size_x() <= 0 || area.size_y() <= 0;
+}
+
+/**
+ * Grows an area of the screen so it covers another one.
+ * @param area Area to grow.
+ * @param other Area to cover, ignored if empty.
+ */
+void uniteArea(GraphSubset &area, const GraphSubset &other)
+{
+	if (isEmptyArea(other))
+	{
+		return;
+	}
+	if (isEmptyArea(area))
+	{
+		area = other;
+		return;
+	}
+	area.beg_x = std::min(area.beg_x, other.beg_x);
+	area.end_x = std::max(area.end_x, other.end_x);
+	area.beg_y = std::min(area.beg_y, other.beg_y);
+	area.end_y = std::max(area.end_y, other.end_y);
+}
+
+/**
+ * Checks if two areas of the screen cover the same pixels.
+ * @param a First area.
+ * @param b Second area.
+ * @return True if they're the same.
+ */
+inline bool isSameArea(const GraphSubset &a, const GraphSubset &b)
+{
+	if (isEmptyArea(a) || isEmptyArea(b))
+	{
+		return isEmptyArea(a) && isEmptyArea(b);
+	}
+	return a.beg_x == b.beg_x && a.end_x == b.end_x && a.beg_y == b.beg_y && a.end_y == b.end_y;
+}
+
+}
+
 /**
  * Sets up a map with the specified size and position.
  * @param game Pointer to the core game.
@@ -74,7 +142,7 @@ namespace OpenXcom
  * @param y Y position in pixels.
  * @param visibleMapHeight Current visible map height.
  */
-Map::Map(Game *game, int width, int height, int x, int y, int visibleMapHeight) : InteractiveSurface(width, height, x, y), _game(game), _arrow(0), _selectorX(0), _selectorY(0), _mouseX(0), _mouseY(0), _cursorType(CT_NORMAL), _cursorSize(1), _animFrame(0), _projectile(0), _projectileInFOV(false), _explosionInFOV(false), _launch(false), _visibleMapHeight(visibleMapHeight), _unitDying(false), _smoothingEngaged(false), _flashScreen(false), _projectileSet(0), _showObstacles(false)
+Map::Map(Game *game, int width, int height, int x, int y, int visibleMapHeight) : InteractiveSurface(width, height, x, y), _game(game), _arrow(0), _selectorX(0), _selectorY(0), _mouseX(0), _mouseY(0), _cursorType(CT_NORMAL), _cursorSize(1), _animFrame(0), _projectile(0), _projectileInFOV(false), _explosionInFOV(false), _launch(false), _visibleMapHeight(visibleMapHeight), _unitDying(false), _smoothingEngaged(false), _flashScreen(false), _projectileSet(0), _showObstacles(false), _arrowArea(0, 0), _viewKey(0), _renderCacheValid(false), _renderFrame(0)
 {
 	_iconHeight = _game->getMod()->getInterface("battlescape")->getElement("icons")->h;
 	_iconWidth = _game->getMod()->getInterface("battlescape")->getElement("icons")->w;
@@ -157,6 +225,7 @@ void Map::init()
 	_arrow->unlock();
 
 	_projectile = 0;
+	_renderCacheValid = false;
 	if (_save->getDepth() == 0)
 	{
 		_projectileSet = _game->getMod()->getSurfaceSet("Projectiles");
@@ -191,7 +260,6 @@ void Map::draw()
 	// but we don't want to clear the background with colour 0, which is transparent (aka black)
 	// we use colour 15 because that actually corresponds to the colour we DO want in all variations of the xcom and tftd palettes.
 	_redraw = false;
-	clear(Palette::blockOffset(0)+15);
 
 	Tile *t;
 
@@ -224,7 +292,9 @@ void Map::draw()
 	}
 	else
 	{
+		clear(Palette::blockOffset(0)+15);
 		_message->blit(this);
+		_renderCacheValid = false;
 	}
 }
 
@@ -237,6 +307,7 @@ void Map::draw()
 void Map::setPalette(SDL_Color *colors, int firstcolor, int ncolors)
 {
 	Surface::setPalette(colors, firstcolor, ncolors);
+	_renderCacheValid = false;
 	for (std::vector<MapDataSet*>::const_iterator i = _save->getMapDataSets()->begin(); i != _save->getMapDataSets()->end(); ++i)
 	{
 		(*i)->getSurfaceset()->setPalette(colors, firstcolor, ncolors);
@@ -497,7 +568,6 @@ void Map::drawTerrain(Surface *surface)
 	int dummy;
 	BattleUnit *unit = 0;
 	int tileShade, wallShade, tileColor, obstacleShade;
-	static const int arrowBob[8] = {0,1,2,1,0,1,2,1};
 
 	NumberText *_numWaypid = 0;
 
@@ -613,6 +683,32 @@ void Map::drawTerrain(Surface *surface)
 	if (beginY < 0)
 		beginY = 0;
 
+	// only draw again what changed since the last time, the rest of the surface is still up to date
+	GraphSubset dirtyArea(0, 0);
+	int reach = 0;
+	bool partial = findDirtyArea(beginX, endX, beginY, endY, beginZ, endZ, dirtyArea, reach);
+	if (partial && isEmptyArea(dirtyArea))
+	{
+		return;
+	}
+	GraphSubset drawArea(std::make_pair(INT_MIN, INT_MAX), std::make_pair(INT_MIN, INT_MAX));
+	if (partial)
+	{
+		// tiles that can draw inside the dirty area, counting units walking in from neighbouring tiles
+		drawArea = GraphSubset(std::make_pair(dirtyArea.beg_x - 2 * _spriteWidth, dirtyArea.end_x + _spriteWidth), std::make_pair(dirtyArea.beg_y - 2 * _spriteHeight, dirtyArea.end_y + reach));
+		SDL_Rect clip;
+		clip.x = dirtyArea.beg_x;
+		clip.y = dirtyArea.beg_y;
+		clip.w = dirtyArea.size_x();
+		clip.h = dirtyArea.size_y();
+		SDL_SetClipRect(surface->getSurface(), &clip);
+		SDL_FillRect(surface->getSurface(), &clip, Palette::blockOffset(0)+15);
+	}
+	else
+	{
+		surface->clear(Palette::blockOffset(0)+15);
+	}
+
 	bool pathfinderTurnedOn = _save->getPathfinding()->isPathPreviewed();
 
 	if (!_waypoints.empty() || (pathfinderTurnedOn && (_previewSetting & PATH_TU_COST)))
@@ -636,7 +732,9 @@ void Map::drawTerrain(Surface *surface)
 
 				// only render cells that are inside the surface
 				if (screenPosition.x > -_spriteWidth && screenPosition.x < surface->getWidth() + _spriteWidth &&
-					screenPosition.y > -_spriteHeight && screenPosition.y < surface->getHeight() + _spriteHeight )
+					screenPosition.y > -_spriteHeight && screenPosition.y < surface->getHeight() + _spriteHeight &&
+					screenPosition.x > drawArea.beg_x && screenPosition.x < drawArea.end_x &&
+					screenPosition.y > drawArea.beg_y && screenPosition.y < drawArea.end_y)
 				{
 					tile = _save->getTile(mapPosition);
 
@@ -1120,7 +1218,9 @@ void Map::drawTerrain(Surface *surface)
 
 					// only render cells that are inside the surface
 					if (screenPosition.x > -_spriteWidth && screenPosition.x < surface->getWidth() + _spriteWidth &&
-						screenPosition.y > -_spriteHeight && screenPosition.y < surface->getHeight() + _spriteHeight )
+						screenPosition.y > -_spriteHeight && screenPosition.y < surface->getHeight() + _spriteHeight &&
+						screenPosition.x > drawArea.beg_x && screenPosition.x < drawArea.end_x &&
+						screenPosition.y > drawArea.beg_y && screenPosition.y < drawArea.end_y)
 					{
 						tile = _save->getTile(mapPosition);
 						Tile *tileBelow = _save->getTile(mapPosition - Position(0,0,1));
@@ -1176,26 +1276,9 @@ void Map::drawTerrain(Surface *surface)
 			_numWaypid->setBordered(false); // make sure we remove the border in case it's being used for missile waypoints.
 		}
 	}
-	unit = (BattleUnit*)_save->getSelectedUnit();
-	if (unit && (_save->getSide() == FACTION_PLAYER || _save->getDebugMode()) && unit->getPosition().z <= _camera->getViewLevel())
+	if (!isEmptyArea(_arrowArea))
 	{
-		_camera->convertMapToScreen(unit->getPosition(), &screenPosition);
-		screenPosition += _camera->getMapOffset();
-		Position offset;
-		calculateWalkingOffset(unit, &offset);
-		if (unit->getArmor()->getSize() > 1)
-		{
-			offset.y += 4;
-		}
-		offset.y += 24 - (unit->getHeight() + unit->getFloatHeight());
-		if (unit->isKneeled())
-		{
-			offset.y -= 2;
-		}
-		if (this->getCursorType() != CT_NONE)
-		{
-			_arrow->blitNShade(surface, screenPosition.x + offset.x + (_spriteWidth / 2) - (_arrow->getWidth() / 2), screenPosition.y + offset.y - _arrow->getHeight() + arrowBob[_animFrame], 0);
-		}
+		_arrow->blitNShade(surface, _arrowArea.beg_x, _arrowArea.beg_y, 0);
 	}
 	delete _numWaypid;
 
@@ -1240,9 +1323,281 @@ void Map::drawTerrain(Surface *surface)
 			}
 		}
 	}
+	SDL_SetClipRect(surface->getSurface(), 0);
 	surface->unlock();
 }
 
+/**
+ * Gets a key of everything that is drawn in a tile's part of the map
+ * during its turn in drawTerrain, apart from units and projectiles.
+ * @param tile The tile.
+ * @param cursor Is the cursor on this tile?
+ * @return The key, changes whenever the tile has to be drawn differently.
+ */
+Uint64 Map::getTileKey(Tile *tile, bool cursor)
+{
+	Uint64 key = KEY_SEED;
+	for (int part = O_FLOOR; part <= O_OBJECT; ++part)
+	{
+		mixKey(key, (size_t)tile->getMapData((TilePart)part));
+		mixKey(key, (size_t)tile->getSprite(part));
+	}
+	mixKey(key, tile->isObstacle() ? tile->getObstacle(0) | tile->getObstacle(1) << 1 | tile->getObstacle(2) << 2 | tile->getObstacle(3) << 3 | tile->getObstacle(4) << 4 : 0);
+	if (_showObstacles && tile->isObstacle())
+	{
+		mixKey(key, _animFrame);
+	}
+	mixKey(key, tile->getShade());
+	mixKey(key, tile->isDiscovered(0) | tile->isDiscovered(1) << 1 | tile->isDiscovered(2) << 2);
+	mixKey(key, tile->getTopItemSprite());
+	mixKey(key, tile->getTerrainLevel());
+	mixKey(key, tile->getSmoke());
+	mixKey(key, tile->getFire());
+	if (tile->getSmoke())
+	{
+		mixKey(key, tile->getAnimationOffset());
+		mixKey(key, _animFrame / 2);
+	}
+	mixKey(key, tile->getMarkerColor());
+	mixKey(key, tile->getPreview());
+	mixKey(key, tile->getTUMarker());
+	if (tile->getPreview() != -1)
+	{
+		mixKey(key, tile->hasNoFloor(_save->getTile(tile->getPosition() + Position(0, 0, -1))));
+	}
+	if (cursor)
+	{
+		BattleUnit *unit = tile->getUnit();
+		mixKey(key, _animFrame + 1);
+		mixKey(key, unit && (unit->getVisible() || _save->getDebugMode()));
+		if (_cursorType == CT_AIM && Options::battleUFOExtenderAccuracy)
+		{
+			// the accuracy display follows the selected unit and weapon, just draw it every time
+			mixKey(key, _renderFrame);
+		}
+	}
+	int waypid = 1;
+	for (std::vector<Position>::const_iterator i = _waypoints.begin(); i != _waypoints.end(); ++i)
+	{
+		if ((*i) == tile->getPosition())
+		{
+			mixKey(key, waypid);
+		}
+		waypid++;
+	}
+	return key;
+}
+
+/**
+ * Gets the area of the map a unit is drawn on, including
+ * its fire and bubbles, wherever it is walking.
+ * @param unit The unit.
+ * @return Screen area, empty if the unit isn't drawn.
+ */
+GraphSubset Map::getUnitArea(BattleUnit *unit)
+{
+	GraphSubset area(0, 0);
+	Tile *tile = _save->getTile(unit->getPosition());
+	if (!tile || tile->getUnit() != unit || !(unit->getVisible() || _save->getDebugMode()))
+	{
+		return area;
+	}
+	Position offset;
+	calculateWalkingOffset(unit, &offset);
+	int size = unit->getArmor()->getSize();
+	for (int x = 0; x < size; ++x)
+	{
+		for (int y = 0; y < size; ++y)
+		{
+			Position screenPosition;
+			_camera->convertMapToScreen(unit->getPosition() + Position(x, y, 0), &screenPosition);
+			screenPosition += _camera->getMapOffset() + offset;
+			uniteArea(area, GraphSubset(std::make_pair(screenPosition.x - _spriteWidth / 2, screenPosition.x + _spriteWidth * 3 / 2), std::make_pair(screenPosition.y - _spriteHeight, screenPosition.y + _spriteHeight)));
+		}
+	}
+	return area;
+}
+
+/**
+ * Compares what the visible part of the map is drawn from with what
+ * it was drawn from last time, and finds the screen area that changed.
+ * Everything outside that area is still up to date on the surface.
+ * Projectiles, explosions and particles always need the whole map drawn.
+ * @param beginX First map column to draw.
+ * @param endX Last map column to draw.
+ * @param beginY First map row to draw.
+ * @param endY Last map row to draw.
+ * @param beginZ First map level to draw.
+ * @param endZ Last map level to draw.
+ * @param area Returns the screen area to draw again.
+ * @param reach Returns how far above its screen position a visible tile can draw.
+ * @return False if the whole map has to be drawn again.
+ */
+bool Map::findDirtyArea(int beginX, int endX, int beginY, int endY, int beginZ, int endZ, GraphSubset &area, int &reach)
+{
+	bool valid = _renderCacheValid && !_projectile && _explosions.empty();
+	bool particles = false;
+	bool mouseOverIcons = _save->getBattleState()->getMouseOverIcons();
+	++_renderFrame;
+	if ((int)_tileKeys.size() != _save->getMapSizeXYZ())
+	{
+		_tileKeys.assign(_save->getMapSizeXYZ(), 0);
+		_tileReach.assign(_save->getMapSizeXYZ(), 0);
+		valid = false;
+	}
+
+	// anything that changes the whole view
+	Uint64 viewKey = KEY_SEED;
+	mixKey(viewKey, _camera->getMapOffset().x);
+	mixKey(viewKey, _camera->getMapOffset().y);
+	mixKey(viewKey, _camera->getMapOffset().z);
+	mixKey(viewKey, _camera->getViewLevel());
+	mixKey(viewKey, beginZ);
+	mixKey(viewKey, endZ);
+	mixKey(viewKey, getWidth());
+	mixKey(viewKey, getHeight());
+	mixKey(viewKey, _save->getDebugMode());
+	mixKey(viewKey, _save->getSide());
+	mixKey(viewKey, (size_t)_save->getSelectedUnit());
+	mixKey(viewKey, _save->getPathfinding()->isPathPreviewed());
+	mixKey(viewKey, _previewSetting);
+	mixKey(viewKey, _cursorType);
+	mixKey(viewKey, _cursorSize);
+	mixKey(viewKey, mouseOverIcons);
+	mixKey(viewKey, _showObstacles);
+	mixKey(viewKey, _waypoints.size());
+	if (!_waypoints.empty())
+	{
+		mixKey(viewKey, _save->getBattleGame()->getCurrentAction()->type);
+	}
+	if (viewKey != _viewKey)
+	{
+		_viewKey = viewKey;
+		valid = false;
+	}
+
+	area = GraphSubset(0, 0);
+	reach = _spriteHeight;
+	Position mapPosition, screenPosition;
+	for (int itZ = beginZ; itZ <= endZ; itZ++)
+	{
+		for (int itX = beginX; itX <= endX; itX++)
+		{
+			for (int itY = beginY; itY <= endY; itY++)
+			{
+				mapPosition = Position(itX, itY, itZ);
+				_camera->convertMapToScreen(mapPosition, &screenPosition);
+				screenPosition += _camera->getMapOffset();
+
+				if (screenPosition.x > -_spriteWidth && screenPosition.x < getWidth() + _spriteWidth &&
+					screenPosition.y > -_spriteHeight && screenPosition.y < getHeight() + _spriteHeight )
+				{
+					Tile *tile = _save->getTile(mapPosition);
+
+					if (!tile) continue;
+
+					if (!tile->getParticleCloud()->empty())
+					{
+						particles = true;
+					}
+					bool cursor = _cursorType != CT_NONE && _selectorX > itX - _cursorSize && _selectorY > itY - _cursorSize && _selectorX < itX+1 && _selectorY < itY+1 && !mouseOverIcons;
+					Uint64 key = getTileKey(tile, cursor);
+					int tileReach = 0;
+					for (int part = O_FLOOR; part <= O_OBJECT; ++part)
+					{
+						if (tile->getMapData((TilePart)part))
+						{
+							tileReach = std::max(tileReach, tile->getMapData((TilePart)part)->getYOffset());
+						}
+					}
+					int index = _save->getTileIndex(mapPosition);
+					if (key != _tileKeys[index] || tileReach != _tileReach[index])
+					{
+						// the tile's sprites, and units drawn while it's their turn
+						int top = std::max(_spriteHeight, std::max(tileReach, _tileReach[index]));
+						uniteArea(area, GraphSubset(std::make_pair(screenPosition.x - _spriteWidth, screenPosition.x + 2 * _spriteWidth), std::make_pair(screenPosition.y - top, screenPosition.y + 2 * _spriteHeight)));
+						_tileKeys[index] = key;
+						_tileReach[index] = tileReach;
+					}
+					reach = std::max(reach, tileReach);
+				}
+			}
+		}
+	}
+
+	for (std::vector<BattleUnit*>::iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+	{
+		UnitRender &render = _unitRenders[*i];
+		GraphSubset unitArea = getUnitArea(*i);
+		Uint64 key = KEY_SEED;
+		if (!isEmptyArea(unitArea))
+		{
+			mixKey(key, unitArea.beg_x);
+			mixKey(key, unitArea.beg_y);
+			mixKey(key, render.version);
+			mixKey(key, (*i)->getStatus());
+			mixKey(key, (*i)->getDirection());
+			mixKey(key, (*i)->getWalkingPhase());
+			mixKey(key, (*i)->getDiagonalWalkingPhase());
+			mixKey(key, (*i)->getVerticalDirection());
+			mixKey(key, (*i)->getPosition().z);
+			mixKey(key, (*i)->getLastPosition().x);
+			mixKey(key, (*i)->getLastPosition().y);
+			mixKey(key, (*i)->getLastPosition().z);
+			mixKey(key, (*i)->getDestination().x);
+			mixKey(key, (*i)->getDestination().y);
+			mixKey(key, (*i)->getDestination().z);
+			mixKey(key, (*i)->getFire() > 0 ? _animFrame / 2 + 1 : 0);
+			mixKey(key, (*i)->getBreathFrame());
+			mixKey(key, (*i)->getHeight());
+			for (int part = 0; part < (*i)->getArmor()->getSize() * (*i)->getArmor()->getSize(); ++part)
+			{
+				mixKey(key, (size_t)(*i)->getCache(part));
+			}
+		}
+		if (key != render.key)
+		{
+			uniteArea(area, render.area);
+			uniteArea(area, unitArea);
+			render.key = key;
+			render.area = unitArea;
+		}
+	}
+
+	GraphSubset arrowArea(0, 0);
+	BattleUnit *unit = _save->getSelectedUnit();
+	if (unit && (_save->getSide() == FACTION_PLAYER || _save->getDebugMode()) && unit->getPosition().z <= _camera->getViewLevel() && _cursorType != CT_NONE)
+	{
+		_camera->convertMapToScreen(unit->getPosition(), &screenPosition);
+		screenPosition += _camera->getMapOffset();
+		Position offset;
+		calculateWalkingOffset(unit, &offset);
+		if (unit->getArmor()->getSize() > 1)
+		{
+			offset.y += 4;
+		}
+		offset.y += 24 - (unit->getHeight() + unit->getFloatHeight());
+		if (unit->isKneeled())
+		{
+			offset.y -= 2;
+		}
+		int x = screenPosition.x + offset.x + (_spriteWidth / 2) - (_arrow->getWidth() / 2);
+		int y = screenPosition.y + offset.y - _arrow->getHeight() + arrowBob[_animFrame];
+		arrowArea = GraphSubset(std::make_pair(x, x + _arrow->getWidth()), std::make_pair(y, y + _arrow->getHeight()));
+	}
+	if (!isSameArea(arrowArea, _arrowArea))
+	{
+		uniteArea(area, _arrowArea);
+		uniteArea(area, arrowArea);
+		_arrowArea = arrowArea;
+	}
+
+	// projectiles, explosions and particles leave no trace of where they were, so draw everything after them too
+	_renderCacheValid = !_projectile && _explosions.empty() && !particles;
+	area = GraphSubset::intersection(area, GraphSubset(getWidth(), getHeight()));
+	return valid && !particles;
+}
+
 /**
  * Handles mouse presses on the map.
  * @param action Pointer to an action.
@@ -1545,6 +1900,7 @@ void Map::cacheUnit(BattleUnit *unit)
 
 	if (unit->isCacheInvalid())
 	{
+		++_unitRenders[unit].version;
 		// 1 or 4 iterations, depending on unit size
 		for (int i = 0; i < numOfParts; i++)
 		{
@@ -1667,6 +2023,7 @@ void Map::refreshSelectorPosition()
 void Map::setHeight(int height)
 {
 	Surface::setHeight(height);
+	_renderCacheValid = false;
 	_visibleMapHeight = height - _iconHeight;
 	_message->setHeight((_visibleMapHeight < 200)? _visibleMapHeight : 200);
 	_message->setY((_visibleMapHeight - _message->getHeight()) / 2);
@@ -1680,6 +2037,7 @@ void Map::setWidth(int width)
 {
 	int dX = width - getWidth();
 	Surface::setWidth(width);
+	_renderCacheValid = false;
 	_message->setX(_message->getX() + dX / 2);
 }
 
@@ -21,6 +21,7 @@
 #include "../Engine/Options.h"
 #include "Position.h"
 #include <vector>
+#include <map>
 
 namespace OpenXcom
 {
@@ -75,6 +76,27 @@ private:
 	int _iconHeight, _iconWidth, _messageColor;
 	const std::vector<Uint8> *_transparencies;
 	bool _showObstacles;
+	/// What was last drawn of a unit, to tell when its part of the map has to be drawn again.
+	struct UnitRender
+	{
+		Uint64 key;
+		GraphSubset area;
+		int version;
+		UnitRender() : key(0), area(0, 0), version(0) {}
+	};
+	std::vector<Uint64> _tileKeys;
+	std::vector<int> _tileReach;
+	std::map<BattleUnit*, UnitRender> _unitRenders;
+	GraphSubset _arrowArea;
+	Uint64 _viewKey;
+	bool _renderCacheValid;
+	int _renderFrame;
+	/// Gets a key of everything a tile's part of the map is drawn from.
+	Uint64 getTileKey(Tile *tile, bool cursor);
+	/// Gets the area of the map a unit is drawn on.
+	GraphSubset getUnitArea(BattleUnit *unit);
+	/// Finds the area of the map that changed since it was last drawn.
+	bool findDirtyArea(int beginX, int endX, int beginY, int endY, int beginZ, int endZ, GraphSubset &area, int &reach);
 public:
 	/// Creates a new map at the specified position and size.
 	Map(Game* game, int width, int height, int x, int y, int visibleMapHeight);
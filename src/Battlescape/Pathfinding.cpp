@@ -19,7 +19,6 @@
 #include <list>
 #include <algorithm>
 #include "Pathfinding.h"
-#include "PathfindingOpenSet.h"
 #include "../Savegame/SavedBattleGame.h"
 #include "../Savegame/Tile.h"
 #include "../Mod/Armor.h"
@@ -38,7 +37,7 @@ int Pathfinding::green = 4;
  * Sets up a Pathfinding.
  * @param save pointer to SavedBattleGame object.
  */
-Pathfinding::Pathfinding(SavedBattleGame *save) : _save(save), _unit(0), _pathPreviewed(false), _strafeMove(false), _totalTUCost(0), _modifierUsed(false), _movementType(MT_WALK)
+Pathfinding::Pathfinding(SavedBattleGame *save) : _save(save), _generation(0), _unit(0), _pathPreviewed(false), _strafeMove(false), _totalTUCost(0), _modifierUsed(false), _movementType(MT_WALK)
 {
 	_size = _save->getMapSizeXYZ();
 	// Initialize one node per tile
@@ -49,6 +48,7 @@ Pathfinding::Pathfinding(SavedBattleGame *save) : _save(save), _unit(0), _pathPr
 		_save->getTileCoords(i, &p.x, &p.y, &p.z);
 		_nodes.push_back(PathfindingNode(p));
 	}
+	_wallCache.resize(_size * MOVEMENT_TYPES, 0);
 }
 
 /**
@@ -62,12 +62,35 @@ Pathfinding::~Pathfinding()
 
 /**
  * Gets the Node on a given position on the map.
+ * Nodes left over from an earlier search are reset on first access.
  * @param pos Position.
  * @return Pointer to node.
  */
 PathfindingNode *Pathfinding::getNode(Position pos)
 {
-	return &_nodes[_save->getTileIndex(pos)];
+	PathfindingNode *node = &_nodes[_save->getTileIndex(pos)];
+	if (!node->isCurrent(_generation))
+	{
+		node->reset(_generation);
+	}
+	return node;
+}
+
+/**
+ * Starts a new search. Bumping the generation makes every node count
+ * as unvisited without touching them; they get reset lazily in getNode().
+ */
+void Pathfinding::newSearch()
+{
+	_openSet.clear();
+	++_generation;
+	if (_generation == 0)
+	{
+		// the counter wrapped around, so old stamps could look current again.
+		for (std::vector<PathfindingNode>::iterator it = _nodes.begin(); it != _nodes.end(); ++it)
+			it->reset(0);
+		_generation = 1;
+	}
 }
 
 /**
@@ -191,20 +214,18 @@ void Pathfinding::calculate(BattleUnit *unit, Position endPosition, BattleUnit *
  */
 bool Pathfinding::aStarPath(Position startPosition, Position endPosition, BattleUnit *target, bool sneak, int maxTUCost)
 {
-	// reset every node, so we have to check them all
-	for (std::vector<PathfindingNode>::iterator it = _nodes.begin(); it != _nodes.end(); ++it)
-		it->reset();
+	// start a fresh search, so we have to check all nodes
+	newSearch();
 
 	// start position is the first one in our "open" list
 	PathfindingNode *start = getNode(startPosition);
 	start->connect(0, 0, 0, endPosition);
-	PathfindingOpenSet openList;
-	openList.push(start);
+	_openSet.push(start);
 	bool missile = (target && maxTUCost == 10000);
 	// if the open list is empty, we've reached the end
-	while (!openList.empty())
+	while (!_openSet.empty())
 	{
-		PathfindingNode *currentNode = openList.pop();
+		PathfindingNode *currentNode = _openSet.pop();
 		Position const &currentPos = currentNode->getPosition();
 		currentNode->setChecked();
 		if (currentPos == endPosition) // We found our target.
@@ -235,7 +256,7 @@ bool Pathfinding::aStarPath(Position startPosition, Position endPosition, Battle
 			if ((!nextNode->inOpenSet() || nextNode->getTUCost(missile) > _totalTUCost) && _totalTUCost <= maxTUCost)
 			{
 				nextNode->connect(_totalTUCost, currentNode, direction, endPosition);
-				openList.push(nextNode);
+				_openSet.push(nextNode);
 			}
 		}
 	}
@@ -296,7 +317,7 @@ int Pathfinding::getTUCost(Position startPosition, int direction, Position *endP
 			if (direction < DIR_UP && startTile->getTerrainLevel() > - 16)
 			{
 				// check if we can go this way
-				if (isBlocked(startTile, destinationTile, direction, target))
+				if (isWallBlocked(startTile, direction, target))
 					return 255;
 				if (startTile->getTerrainLevel() - destinationTile->getTerrainLevel() > 8)
 					return 255;
@@ -347,7 +368,7 @@ int Pathfinding::getTUCost(Position startPosition, int direction, Position *endP
 			if (direction < DIR_UP && endPosition->z == startTile->getPosition().z)
 			{
 				// check if we can go this way
-				if (isBlocked(startTile, destinationTile, direction, target))
+				if (isWallBlocked(startTile, direction, target))
 					return 255;
 				if (startTile->getTerrainLevel() - destinationTile->getTerrainLevel() > 8)
 					return 255;
@@ -381,7 +402,7 @@ int Pathfinding::getTUCost(Position startPosition, int direction, Position *endP
 			if (direction < DIR_UP && numberOfPartsGoingUp != 0)
 			{
 				// check if we can go this way
-				if (isBlocked(startTile, destinationTile, direction, target))
+				if (isWallBlocked(startTile, direction, target))
 					return 255;
 				if (startTile->getTerrainLevel() - destinationTile->getTerrainLevel() > 8)
 					return 255;
@@ -500,14 +521,14 @@ int Pathfinding::getTUCost(Position startPosition, int direction, Position *endP
 		Tile *startTile = _save->getTile(*endPosition + Position(1,1,0));
 		Tile *destinationTile = _save->getTile(*endPosition);
 		int tmpDirection = 7;
-		if (isBlocked(startTile, destinationTile, tmpDirection, target))
+		if (isWallBlocked(startTile, tmpDirection, target))
 			return 255;
 		if (!fellDown && abs(startTile->getTerrainLevel() - destinationTile->getTerrainLevel()) > 10)
 			return 255;
 		startTile = _save->getTile(*endPosition + Position(1,0,0));
 		destinationTile = _save->getTile(*endPosition + Position(0,1,0));
 		tmpDirection = 5;
-		if (isBlocked(startTile, destinationTile, tmpDirection, target))
+		if (isWallBlocked(startTile, tmpDirection, target))
 			return 255;
 		if (!fellDown && abs(startTile->getTerrainLevel() - destinationTile->getTerrainLevel()) > 10)
 			return 255;
@@ -774,6 +795,58 @@ bool Pathfinding::isBlocked(Tile *startTile, Tile * /* endTile */, const int dir
 	return false;
 }
 
+/**
+ * Determines whether walls block movement out of a tile in a given direction.
+ * This is the same as isBlocked(startTile, endTile, direction, missileTarget),
+ * but the answer only depends on terrain and movement type, so it is remembered
+ * per tile until invalidateTerrain() is called for a nearby tile.
+ * Missiles also check doors, so their queries bypass the cache.
+ * @param startTile The tile to start from.
+ * @param direction The direction we are facing.
+ * @param missileTarget Target for a missile.
+ * @return True if the movement is blocked.
+ */
+bool Pathfinding::isWallBlocked(Tile *startTile, const int direction, BattleUnit *missileTarget)
+{
+	if (missileTarget != 0)
+	{
+		return isBlocked(startTile, 0, direction, missileTarget);
+	}
+	Uint16 &cache = _wallCache[_save->getTileIndex(startTile->getPosition()) * MOVEMENT_TYPES + _movementType];
+	const Uint16 known = 1 << direction;
+	const Uint16 blocked = known << 8;
+	if ((cache & known) == 0)
+	{
+		cache |= known;
+		if (isBlocked(startTile, 0, direction, 0))
+		{
+			cache |= blocked;
+		}
+	}
+	return (cache & blocked) != 0;
+}
+
+/**
+ * Forgets the cached wall blockage of every tile that looks at @a pos
+ * when checking its walls, i.e. the tile itself and its horizontal neighbours.
+ * Call this whenever the terrain of a tile changes (destruction, doors).
+ * @param pos Position of the changed tile.
+ */
+void Pathfinding::invalidateTerrain(Position pos)
+{
+	for (int x = pos.x - 1; x <= pos.x + 1; ++x)
+	{
+		for (int y = pos.y - 1; y <= pos.y + 1; ++y)
+		{
+			Position p(x, y, pos.z);
+			if (_save->getTile(p) == 0)
+				continue;
+			int index = _save->getTileIndex(p) * MOVEMENT_TYPES;
+			std::fill(_wallCache.begin() + index, _wallCache.begin() + index + MOVEMENT_TYPES, 0);
+		}
+	}
+}
+
 /**
  * Determines whether a unit can fall down from this tile.
  * We can fall down here, if the tile does not exist, the tile has no floor
@@ -1169,61 +1242,76 @@ bool Pathfinding::bresenhamPath(Position origin, Position target, BattleUnit *ta
 
 /**
  * Locates all tiles reachable to @a *unit with a TU cost no more than @a tuMax.
- * Uses Dijkstra's algorithm.
+ * Uses Dijkstra's algorithm with the same step costs as calculate(), including
+ * sneaking aliens avoiding visible tiles. The whole search is kept in the result,
+ * so the cost and path to any of the tiles can be looked up later without searching again.
  * @param unit Pointer to the unit.
  * @param tuMax The maximum cost of the path to each tile.
- * @return An array of reachable tiles, sorted in ascending order of cost. The first tile is the start location.
+ * @return A field with every reachable tile, including the start location.
  */
-std::vector<int> Pathfinding::findReachable(BattleUnit *unit, int tuMax)
+PathfindingField Pathfinding::findReachable(BattleUnit *unit, int tuMax)
 {
+	bool sneak = Options::sneakyAI && unit->getFaction() == FACTION_HOSTILE;
 	Position start = unit->getPosition();
 	int energyMax = unit->getEnergy();
-	for (std::vector<PathfindingNode>::iterator it = _nodes.begin(); it != _nodes.end(); ++it)
-	{
-		it->reset();
-	}
+	setUnit(unit);
+	newSearch();
 	PathfindingNode *startNode = getNode(start);
 	startNode->connect(0, 0, 0);
-	PathfindingOpenSet unvisited;
-	unvisited.push(startNode);
-	std::vector<PathfindingNode*> reachable;
-	while (!unvisited.empty())
+	_openSet.push(startNode);
+	// the nodes keep the cost with sneaking added, this keeps the TUs the unit actually spends
+	std::vector<int> spent(_save->getMapSizeXYZ(), 0);
+	PathfindingField reachable;
+	while (!_openSet.empty())
 	{
-		PathfindingNode *currentNode = unvisited.pop();
+		PathfindingNode *currentNode = _openSet.pop();
 		Position const &currentPos = currentNode->getPosition();
+		int currentIndex = _save->getTileIndex(currentPos);
 
 		// Try all reachable neighbours.
 		for (int direction = 0; direction < 10; direction++)
 		{
 			Position nextPos;
 			int tuCost = getTUCost(currentPos, direction, &nextPos, unit, 0, false);
-			if (tuCost == 255) // Skip unreachable / blocked
+			if (tuCost >= 255) // Skip unreachable / blocked
 				continue;
-			if (currentNode->getTUCost(false) + tuCost > tuMax ||
-				(currentNode->getTUCost(false) + tuCost) / 2 > energyMax) // Run out of TUs/Energy
+			int sneakCost = tuCost;
+			if (sneak && _save->getTile(nextPos)->getVisible()) sneakCost *= 2; // avoid being seen
+			int totalTuCost = currentNode->getTUCost(false) + sneakCost;
+			if (totalTuCost > tuMax || totalTuCost / 2 > energyMax) // Run out of TUs/Energy
 				continue;
 			PathfindingNode *nextNode = getNode(nextPos);
 			if (nextNode->isChecked()) // Our algorithm means this node is already at minimum cost.
 				continue;
-			int totalTuCost = currentNode->getTUCost(false) + tuCost;
 			// If this node is unvisited or visited from a better path.
 			if (!nextNode->inOpenSet() || nextNode->getTUCost(false) > totalTuCost)
 			{
 				nextNode->connect(totalTuCost, currentNode, direction);
-				unvisited.push(nextNode);
+				spent[_save->getTileIndex(nextPos)] = spent[currentIndex] + tuCost;
+				_openSet.push(nextNode);
 			}
 		}
 		currentNode->setChecked();
-		reachable.push_back(currentNode);
-	}
-	std::sort(reachable.begin(), reachable.end(), MinNodeCosts());
-	std::vector<int> tiles;
-	tiles.reserve(reachable.size());
-	for (std::vector<PathfindingNode*>::const_iterator it = reachable.begin(); it != reachable.end(); ++it)
-	{
-		tiles.push_back(_save->getTileIndex((*it)->getPosition()));
+		PathfindingNode *prevNode = currentNode->getPrevNode();
+		reachable.add(currentIndex, spent[currentIndex],
+			prevNode ? _save->getTileIndex(prevNode->getPosition()) : -1, currentNode->getPrevDir());
 	}
-	return tiles;
+	reachable.finalize();
+	return reachable;
+}
+
+/**
+ * Sets a path found in advance, like one from findReachable(),
+ * so the unit walks it instead of calculating a new one.
+ * @param unit Unit taking the path.
+ * @param path The directions of the path, in reverse order like getPath().
+ */
+void Pathfinding::setPath(BattleUnit *unit, const std::vector<int> &path)
+{
+	setUnit(unit);
+	_strafeMove = false;
+	_totalTUCost = 0;
+	_path = path;
 }
 
 /**
@@ -18,8 +18,11 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <vector>
+#include <SDL_types.h>
 #include "Position.h"
 #include "PathfindingNode.h"
+#include "PathfindingOpenSet.h"
+#include "PathfindingField.h"
 #include "../Mod/MapData.h"
 
 namespace OpenXcom
@@ -37,6 +40,9 @@ class Pathfinding
 private:
 	SavedBattleGame *_save;
 	std::vector<PathfindingNode> _nodes;
+	PathfindingOpenSet _openSet;
+	/// Stamp of the current search; nodes with another stamp count as unvisited.
+	unsigned int _generation;
 	int _size;
 	BattleUnit *_unit;
 	bool _pathPreviewed;
@@ -44,10 +50,17 @@ private:
 	int _totalTUCost;
 	bool _modifierUsed;
 	MovementType _movementType;
+	static const int MOVEMENT_TYPES = MT_SINK + 1;
+	/// Cached wall blockage per tile and movement type: low byte marks known directions, high byte blocked ones.
+	std::vector<Uint16> _wallCache;
 	/// Gets the node at certain position.
 	PathfindingNode *getNode(Position pos);
+	/// Starts a new search, invalidating all nodes at once.
+	void newSearch();
 	/// Determines whether a tile blocks a certain movementType.
 	bool isBlocked(Tile *tile, const int part, BattleUnit *missileTarget, int bigWallExclusion = -1) const;
+	/// Determines whether walls block leaving a tile in a direction, using the cache when possible.
+	bool isWallBlocked(Tile *startTile, const int direction, BattleUnit *missileTarget);
 	/// Tries to find a straight line path between two positions.
 	bool bresenhamPath(Position origin, Position target, BattleUnit *missileTarget, bool sneak = false, int maxTUCost = 1000);
 	/// Tries to find a path between two positions.
@@ -95,10 +108,14 @@ public:
 	bool previewPath(bool bRemove = false);
 	/// Removes the path preview.
 	bool removePreview();
+	/// Forgets cached movement data around a tile whose terrain changed.
+	void invalidateTerrain(Position pos);
 	/// Sets _unit in order to abuse low-level pathfinding functions from outside the class.
 	void setUnit(BattleUnit *unit);
-	/// Gets all reachable tiles, based on cost.
-	std::vector<int> findReachable(BattleUnit *unit, int tuMax);
+	/// Gets all reachable tiles, with their costs and paths.
+	PathfindingField findReachable(BattleUnit *unit, int tuMax);
+	/// Sets a path found in advance.
+	void setPath(BattleUnit *unit, const std::vector<int> &path);
 	/// Gets _totalTUCost; finds out whether we can hike somewhere in this turn or not.
 	int getTotalTUCost() const { return _totalTUCost; }
 	/// Gets the path preview setting.
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include "PathfindingField.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Sets up an empty PathfindingField.
+ */
+PathfindingField::PathfindingField()
+{
+
+}
+
+/**
+ * Adds a reachable tile to the field.
+ * @param tile Index of the tile.
+ * @param tuCost The TU cost to reach the tile.
+ * @param prevTile Index of the tile we came from, -1 for the start tile.
+ * @param prevDir The direction FROM the previous tile.
+ */
+void PathfindingField::add(int tile, int tuCost, int prevTile, int prevDir)
+{
+	Entry entry = { tile, tuCost, prevTile, prevDir };
+	_entries.push_back(entry);
+}
+
+/**
+ * Sorts the tiles so they can be looked up quickly.
+ * Has to be called once after the last tile was added.
+ */
+void PathfindingField::finalize()
+{
+	std::sort(_entries.begin(), _entries.end());
+}
+
+/**
+ * Removes all tiles from the field.
+ */
+void PathfindingField::clear()
+{
+	_entries.clear();
+}
+
+/**
+ * Gets the entry of a tile.
+ * @param tile Index of the tile.
+ * @return Pointer to the entry, or 0 if the tile is not reachable.
+ */
+const PathfindingField::Entry *PathfindingField::find(int tile) const
+{
+	Entry key = { tile, 0, 0, 0 };
+	std::vector<Entry>::const_iterator i = std::lower_bound(_entries.begin(), _entries.end(), key);
+	if (i != _entries.end() && i->tile == tile)
+		return &*i;
+	return 0;
+}
+
+/**
+ * Gets the TU cost to reach a tile.
+ * @param tile Index of the tile.
+ * @return The TU cost, or -1 if the tile is not reachable.
+ */
+int PathfindingField::getTUCost(int tile) const
+{
+	const Entry *entry = find(tile);
+	return entry ? entry->tuCost : -1;
+}
+
+/**
+ * Gets the path to a tile. Like Pathfinding::getPath(), the directions
+ * are stored in reverse order, so the first step is at the back.
+ * @param tile Index of the tile.
+ * @return The path, empty if the tile is the start or not reachable.
+ */
+std::vector<int> PathfindingField::getPath(int tile) const
+{
+	std::vector<int> path;
+	const Entry *entry = find(tile);
+	while (entry && entry->prevTile != -1)
+	{
+		path.push_back(entry->prevDir);
+		entry = find(entry->prevTile);
+	}
+	return path;
+}
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+
+namespace OpenXcom
+{
+
+/**
+ * The result of a single Pathfinding::findReachable() search:
+ * the TU cost and the way back to the start for every tile a unit can reach.
+ * Lets callers ask for the cost or the path to any number of tiles
+ * without searching the map again.
+ */
+class PathfindingField
+{
+private:
+	struct Entry
+	{
+		int tile;
+		int tuCost;
+		int prevTile;
+		int prevDir;
+		bool operator<(const Entry &other) const { return tile < other.tile; }
+	};
+	std::vector<Entry> _entries;
+	/// Gets the entry of a tile.
+	const Entry *find(int tile) const;
+public:
+	/// Creates an empty PathfindingField.
+	PathfindingField();
+	/// Adds a reachable tile.
+	void add(int tile, int tuCost, int prevTile, int prevDir);
+	/// Prepares the field for lookups after all tiles have been added.
+	void finalize();
+	/// Removes all tiles.
+	void clear();
+	/// Is the tile reachable?
+	bool isReachable(int tile) const { return find(tile) != 0; }
+	/// Gets the TU cost to reach a tile.
+	int getTUCost(int tile) const;
+	/// Gets the path to a tile.
+	std::vector<int> getPath(int tile) const;
+};
+
+}
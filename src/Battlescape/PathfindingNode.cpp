@@ -26,7 +26,7 @@ namespace OpenXcom
  * Sets up a PathfindingNode.
  * @param pos Position.
  */
-PathfindingNode::PathfindingNode(Position pos) : _pos(pos), _checked(0), _tuCost(0), _prevNode(0), _prevDir(0), _tuGuess(0), _openentry(0)
+PathfindingNode::PathfindingNode(Position pos) : _pos(pos), _generation(0), _checked(0), _tuCost(0), _prevNode(0), _prevDir(0), _tuGuess(0), _openIndex(-1), _openCost(0)
 {
 
 }
@@ -49,12 +49,14 @@ Position PathfindingNode::getPosition() const
 }
 
 /**
- * Resets the node.
+ * Resets the node, making it belong to another search.
+ * @param generation The search the node will now belong to.
  */
-void PathfindingNode::reset()
+void PathfindingNode::reset(unsigned int generation)
 {
+	_generation = generation;
 	_checked = false;
-	_openentry = 0;
+	_openIndex = -1;
 }
 
 /**
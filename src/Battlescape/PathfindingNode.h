@@ -23,7 +23,6 @@ namespace OpenXcom
 {
 
 class PathfindingOpenSet;
-struct OpenSetEntry;
 
 /**
  * A class that holds pathfinding info for a certain node on the map.
@@ -32,14 +31,16 @@ class PathfindingNode
 {
 private:
 	Position _pos;
+	/// The search this node's state belongs to.
+	unsigned int _generation;
 	bool _checked;
 	int _tuCost;
 	PathfindingNode* _prevNode;
 	int _prevDir;
 	/// Approximate cost to reach goal position.
 	int _tuGuess;
-	// Invasive field needed by PathfindingOpenSet
-	OpenSetEntry *_openentry;
+	// Invasive fields needed by PathfindingOpenSet
+	int _openIndex, _openCost;
 	friend class PathfindingOpenSet;
 public:
 	/// Creates a new PathfindingNode class.
@@ -48,8 +49,10 @@ public:
 	~PathfindingNode();
 	/// Gets the node position.
 	Position getPosition() const;
-	/// Resets the node.
-	void reset();
+	/// Resets the node for a new search.
+	void reset(unsigned int generation);
+	/// Is the node state from this search?
+	bool isCurrent(unsigned int generation) const { return _generation == generation; }
 	/// Is checked?
 	bool isChecked() const;
 	/// Marks the node as checked.
@@ -61,7 +64,7 @@ public:
 	/// Gets the previous walking direction.
 	int getPrevDir() const;
 	/// Is this node already in a PathfindingOpenSet?
-	bool inOpenSet() const { return (_openentry != 0); }
+	bool inOpenSet() const { return (_openIndex != -1); }
 	/// Gets the approximate cost to reach the target position.
 	int getTUGuess() const { return _tuGuess; }
 
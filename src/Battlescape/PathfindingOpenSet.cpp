@@ -24,29 +24,16 @@ namespace OpenXcom
 {
 
 /**
- * Cleans up all the entries still in set.
+ * Removes all nodes from the set, so it can be reused for another search
+ * without giving back the memory it has grown to.
  */
-PathfindingOpenSet::~PathfindingOpenSet()
+void PathfindingOpenSet::clear()
 {
-	while (!_queue.empty())
+	for (std::vector<PathfindingNode*>::iterator i = _heap.begin(); i != _heap.end(); ++i)
 	{
-		OpenSetEntry *entry = _queue.top();
-		_queue.pop();
-		delete entry;
-	}
-}
-
-/**
- * Keeps removing all discarded entries that have come to the top of the queue.
- */
-void PathfindingOpenSet::removeDiscarded()
-{
-	while (!_queue.empty() && !_queue.top()->_node)
-	{
-		OpenSetEntry *entry = _queue.top();
-		_queue.pop();
-		delete entry;
+		(*i)->_openIndex = -1;
 	}
+	_heap.clear();
 }
 
 /**
@@ -57,33 +44,87 @@ void PathfindingOpenSet::removeDiscarded()
 PathfindingNode *PathfindingOpenSet::pop()
 {
 	assert(!empty());
-	OpenSetEntry *entry = _queue.top();
-	PathfindingNode *nd = entry->_node;
-	_queue.pop();
-	delete entry;
-	nd->_openentry = 0;
-
-	// Discarded entries might be visible now.
-	removeDiscarded();
+	PathfindingNode *nd = _heap.front();
+	PathfindingNode *last = _heap.back();
+	_heap.pop_back();
+	if (last != nd)
+	{
+		place(last, 0);
+		siftDown(0);
+	}
+	nd->_openIndex = -1;
 	return nd;
 }
 
 /**
  * Places the node in the set.
- * If the node was already in the set, the previous entry is discarded.
+ * If the node was already in the set, its position is updated to match the new cost.
  * It is the caller's responsibility to never re-add a node with a worse cost.
  * @param node A pointer to the node to add.
  */
 void PathfindingOpenSet::push(PathfindingNode *node)
 {
-	OpenSetEntry *entry = new OpenSetEntry;
-	entry->_node = node;
-	entry->_cost = node->getTUCost(false) + node->getTUGuess();
-	if (node->_openentry)
-		node->_openentry->_node = 0;
-	node->_openentry = entry;
-	_queue.push(entry);
+	node->_openCost = node->getTUCost(false) + node->getTUGuess();
+	if (node->_openIndex == -1)
+	{
+		_heap.push_back(node);
+		node->_openIndex = _heap.size() - 1;
+	}
+	siftUp(node->_openIndex);
+}
+
+/**
+ * Moves the node at @a index towards the top of the heap
+ * for as long as it is cheaper than its parent.
+ * @param index The heap slot of the node.
+ */
+void PathfindingOpenSet::siftUp(int index)
+{
+	PathfindingNode *node = _heap[index];
+	while (index > 0)
+	{
+		int parent = (index - 1) / 2;
+		if (_heap[parent]->_openCost <= node->_openCost)
+			break;
+		place(_heap[parent], index);
+		index = parent;
+	}
+	place(node, index);
 }
 
+/**
+ * Moves the node at @a index towards the bottom of the heap
+ * for as long as one of its children is cheaper.
+ * @param index The heap slot of the node.
+ */
+void PathfindingOpenSet::siftDown(int index)
+{
+	PathfindingNode *node = _heap[index];
+	int size = _heap.size();
+	while (true)
+	{
+		int child = index * 2 + 1;
+		if (child >= size)
+			break;
+		if (child + 1 < size && _heap[child + 1]->_openCost < _heap[child]->_openCost)
+			++child;
+		if (node->_openCost <= _heap[child]->_openCost)
+			break;
+		place(_heap[child], index);
+		index = child;
+	}
+	place(node, index);
+}
+
+/**
+ * Stores the node in a heap slot and lets the node know where it is.
+ * @param node A pointer to the node.
+ * @param index The heap slot.
+ */
+void PathfindingOpenSet::place(PathfindingNode *node, int index)
+{
+	_heap[index] = node;
+	node->_openIndex = index;
+}
 
 }
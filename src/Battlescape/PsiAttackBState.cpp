@@ -186,7 +186,7 @@ void PsiAttackBState::psiAttack()
 			}
 			_target->setMindControllerId(_unit->getId());
 			_target->convertToFaction(_unit->getFaction());
-			_parent->getTileEngine()->calculateFOV(_target->getPosition());
+			_parent->getTileEngine()->calculateFOV(_target->getPosition(), 1, false);
 			_parent->getTileEngine()->calculateUnitLighting();
 			_target->recoverTimeUnits();
 			_target->allowReselect();
@@ -18,7 +18,8 @@
  */
 #include <assert.h>
 #include <climits>
-#include <set>
+#include <algorithm>
+#include <iterator>
 #include "TileEngine.h"
 #include <SDL.h>
 #include "AIModule.h"
@@ -39,6 +40,7 @@
 #include "../Mod/Armor.h"
 #include "Pathfinding.h"
 #include "../Engine/Options.h"
+#include "../Engine/Logger.h"
 #include "ProjectileFlyBState.h"
 #include "MeleeAttackBState.h"
 #include "../fmath.h"
@@ -48,12 +50,48 @@ namespace OpenXcom
 
 const int TileEngine::heightFromCenter[11] = {0,-2,+2,-4,+4,-6,+6,-8,+8,-12,+12};
 
+namespace
+{
+
+/// Sines and cosines of the ray angles explode() uses.
+struct ExplosionRays
+{
+	double sinTe[121], cosTe[121], sinFi[37], cosFi[37];
+};
+
+/**
+ * Works out the sines and cosines of the explosion rays:
+ * every 3 degrees around and every 5 degrees up and down.
+ * @return Table of the ray angles.
+ */
+ExplosionRays buildExplosionRays()
+{
+	ExplosionRays rays;
+	for (int te = 0; te <= 360; te += 3)
+	{
+		rays.cosTe[te / 3] = cos(Deg2Rad(te));
+		rays.sinTe[te / 3] = sin(Deg2Rad(te));
+	}
+	for (int fi = -90; fi <= 90; fi += 5)
+	{
+		rays.sinFi[(fi + 90) / 5] = sin(Deg2Rad(fi));
+		rays.cosFi[(fi + 90) / 5] = cos(Deg2Rad(fi));
+	}
+	return rays;
+}
+
+const ExplosionRays explosionRays = buildExplosionRays();
+
+}
+
 /**
  * Sets up a TileEngine.
  * @param save Pointer to SavedBattleGame object.
  * @param voxelData List of voxel data.
  */
-TileEngine::TileEngine(SavedBattleGame *save, std::vector<Uint16> *voxelData) : _save(save), _voxelData(voxelData), _personalLighting(true), _cacheTile(0), _cacheTileBelow(0)
+TileEngine::TileEngine(SavedBattleGame *save, std::vector<Uint16> *voxelData) : _save(save), _voxelData(voxelData), _lightSources(3), _lightValid(3, false),
+	_personalLighting(true), _cacheTile(0), _cacheTileBelow(0), _skipEmptyTiles(true), _checkingLine(false), _explosionGeneration(0),
+	_lofCacheDepth(0), _lofCacheChanges(0), _lofCacheLookups(0), _lofCacheHits(0)
 {
 	_cacheTilePos = Position(-1,-1,-1);
 }
@@ -118,43 +156,45 @@ void TileEngine::calculateTerrainLighting()
 	const int layer = 1; // Static lighting layer.
 	const int fireLightPower = 15; // amount of light a fire generates
 
-	// reset all light to 0 first
+	std::vector<LightSource> sources;
 	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
 	{
-		_save->getTiles()[i]->resetLight(layer);
-	}
+		Tile *tile = _save->getTiles()[i];
+		LightSource source;
+		source.pos = tile->getPosition();
 
-	// add lighting of terrain
-	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
-	{
 		// only floors and objects can light up
-		if (_save->getTiles()[i]->getMapData(O_FLOOR)
-			&& _save->getTiles()[i]->getMapData(O_FLOOR)->getLightSource())
+		if (tile->getMapData(O_FLOOR)
+			&& tile->getMapData(O_FLOOR)->getLightSource())
 		{
-			addLight(_save->getTiles()[i]->getPosition(), _save->getTiles()[i]->getMapData(O_FLOOR)->getLightSource(), layer);
+			source.power = tile->getMapData(O_FLOOR)->getLightSource();
+			sources.push_back(source);
 		}
-		if (_save->getTiles()[i]->getMapData(O_OBJECT)
-			&& _save->getTiles()[i]->getMapData(O_OBJECT)->getLightSource())
+		if (tile->getMapData(O_OBJECT)
+			&& tile->getMapData(O_OBJECT)->getLightSource())
 		{
-			addLight(_save->getTiles()[i]->getPosition(), _save->getTiles()[i]->getMapData(O_OBJECT)->getLightSource(), layer);
+			source.power = tile->getMapData(O_OBJECT)->getLightSource();
+			sources.push_back(source);
 		}
 
 		// fires
-		if (_save->getTiles()[i]->getFire())
+		if (tile->getFire())
 		{
-			addLight(_save->getTiles()[i]->getPosition(), fireLightPower, layer);
+			source.power = fireLightPower;
+			sources.push_back(source);
 		}
 
-		for (std::vector<BattleItem*>::iterator it = _save->getTiles()[i]->getInventory()->begin(); it != _save->getTiles()[i]->getInventory()->end(); ++it)
+		for (std::vector<BattleItem*>::iterator it = tile->getInventory()->begin(); it != tile->getInventory()->end(); ++it)
 		{
 			if ((*it)->getRules()->getBattleType() == BT_FLARE)
 			{
-				addLight(_save->getTiles()[i]->getPosition(), (*it)->getRules()->getPower(), layer);
+				source.power = (*it)->getRules()->getPower();
+				sources.push_back(source);
 			}
 		}
-
 	}
 
+	applyLightSources(layer, sources);
 }
 
 /**
@@ -166,58 +206,172 @@ void TileEngine::calculateUnitLighting()
 	const int personalLightPower = 15; // amount of light a unit generates
 	const int fireLightPower = 15; // amount of light a fire generates
 
-	// reset all light to 0 first
-	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
-	{
-		_save->getTiles()[i]->resetLight(layer);
-	}
-
+	std::vector<LightSource> sources;
 	for (std::vector<BattleUnit*>::iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
 	{
+		LightSource source;
+		source.pos = (*i)->getPosition();
 		// add lighting of soldiers
 		if (_personalLighting && (*i)->getFaction() == FACTION_PLAYER && !(*i)->isOut())
 		{
-			addLight((*i)->getPosition(), personalLightPower, layer);
+			source.power = personalLightPower;
+			sources.push_back(source);
 		}
 		// add lighting of units on fire
 		if ((*i)->getFire())
 		{
-			addLight((*i)->getPosition(), fireLightPower, layer);
+			source.power = fireLightPower;
+			sources.push_back(source);
 		}
 	}
+
+	applyLightSources(layer, sources);
 }
 
 /**
- * Adds circular light pattern starting from center and losing power with distance travelled.
- * @param center Center.
- * @param power Power.
+ * Updates a lighting layer for a new set of light sources.
+ * Only the columns of tiles lit by sources that were added or removed since the last
+ * update are reset, and only the sources reaching those columns are added again.
+ * The first update of a layer lights the whole map.
  * @param layer Light is separated in 3 layers: Ambient, Static and Dynamic.
+ * @param sources The light sources on this layer. Gets sorted.
  */
-void TileEngine::addLight(Position center, int power, int layer)
+void TileEngine::applyLightSources(int layer, std::vector<LightSource> &sources)
 {
-	// only loop through the positive quadrant.
-	for (int x = 0; x <= power; ++x)
+	std::sort(sources.begin(), sources.end());
+	std::vector<LightSource> &old = _lightSources[layer];
+	int sizeX = _save->getMapSizeX(), sizeY = _save->getMapSizeY();
+
+	if (!_lightValid[layer] || (int)_lightDirty.size() != sizeX * sizeY)
 	{
-		for (int y = 0; y <= power; ++y)
+		// reset all light to 0 first
+		std::fill(_save->getTileStore()->light[layer].begin(), _save->getTileStore()->light[layer].end(), 0);
+		for (std::vector<LightSource>::iterator i = sources.begin(); i != sources.end(); ++i)
 		{
-			for (int z = 0; z < _save->getMapSizeZ(); z++)
-			{
-				int distance = (int)Round(sqrt(float(x*x + y*y)));
+			addLight(i->pos, i->power, layer);
+		}
+		_lightDirty.assign(sizeX * sizeY, 0);
+		_lightValid[layer] = true;
+		old.swap(sources);
+		return;
+	}
 
-				if (_save->getTile(Position(center.x + x,center.y + y, z)))
-					_save->getTile(Position(center.x + x,center.y + y, z))->addLight(power - distance, layer);
+	std::vector<LightSource> changed;
+	std::set_symmetric_difference(old.begin(), old.end(), sources.begin(), sources.end(), std::back_inserter(changed));
+	if (changed.empty())
+	{
+		return;
+	}
 
-				if (_save->getTile(Position(center.x - x,center.y - y, z)))
-					_save->getTile(Position(center.x - x,center.y - y, z))->addLight(power - distance, layer);
+	// mark the columns the changed sources light up
+	int minX = sizeX, maxX = -1, minY = sizeY, maxY = -1;
+	for (std::vector<LightSource>::iterator i = changed.begin(); i != changed.end(); ++i)
+	{
+		const std::vector<LightStamp> &stamp = getLightStamp(i->power);
+		for (std::vector<LightStamp>::const_iterator j = stamp.begin(); j != stamp.end(); ++j)
+		{
+			int x = i->pos.x + j->x;
+			int y = i->pos.y + j->y;
+			if (x >= 0 && x < sizeX && y >= 0 && y < sizeY)
+			{
+				_lightDirty[y * sizeX + x] = 1;
+				minX = std::min(minX, x);
+				maxX = std::max(maxX, x);
+				minY = std::min(minY, y);
+				maxY = std::max(maxY, y);
+			}
+		}
+	}
+
+	// reset them, and let every source that reaches them shine on them again
+	std::vector<int> &light = _save->getTileStore()->light[layer];
+	for (int y = minY; y <= maxY; ++y)
+	{
+		for (int x = minX; x <= maxX; ++x)
+		{
+			if (_lightDirty[y * sizeX + x])
+			{
+				for (int z = 0; z < _save->getMapSizeZ(); ++z)
+				{
+					light[z * sizeX * sizeY + y * sizeX + x] = 0;
+				}
+			}
+		}
+	}
+	for (std::vector<LightSource>::iterator i = sources.begin(); i != sources.end(); ++i)
+	{
+		if (i->pos.x + i->power > minX && i->pos.x - i->power < maxX
+			&& i->pos.y + i->power > minY && i->pos.y - i->power < maxY)
+		{
+			addLight(i->pos, i->power, layer, true);
+		}
+	}
+	for (int y = minY; y <= maxY; ++y)
+	{
+		std::fill(_lightDirty.begin() + y * sizeX + minX, _lightDirty.begin() + y * sizeX + maxX + 1, 0);
+	}
 
-				if (_save->getTile(Position(center.x - x,center.y + y, z)))
-					_save->getTile(Position(center.x - x,center.y + y, z))->addLight(power - distance, layer);
+	old.swap(sources);
+}
 
-				if (_save->getTile(Position(center.x + x,center.y - y, z)))
-					_save->getTile(Position(center.x + x,center.y - y, z))->addLight(power - distance, layer);
+/**
+ * Gets the columns of tiles a light source of a certain power reaches,
+ * with the light it gives each of them. Worked out once per power.
+ * @param power Power of the light source.
+ * @return The lit columns, relative to the light source.
+ */
+const std::vector<TileEngine::LightStamp> &TileEngine::getLightStamp(int power)
+{
+	power = std::max(power, 0);
+	if ((int)_lightStamps.size() <= power)
+	{
+		_lightStamps.resize(power + 1);
+	}
+	std::vector<LightStamp> &stamp = _lightStamps[power];
+	if (stamp.empty())
+	{
+		for (int x = -power; x <= power; ++x)
+		{
+			for (int y = -power; y <= power; ++y)
+			{
+				int distance = (int)Round(sqrt(float(x*x + y*y)));
+				if (power - distance > 0)
+				{
+					LightStamp lit = { x, y, power - distance };
+					stamp.push_back(lit);
+				}
 			}
 		}
 	}
+	return stamp;
+}
+
+/**
+ * Adds circular light pattern starting from center and losing power with distance travelled.
+ * @param center Center.
+ * @param power Power.
+ * @param layer Light is separated in 3 layers: Ambient, Static and Dynamic.
+ * @param dirtyOnly Only light up the columns marked for relighting.
+ */
+void TileEngine::addLight(Position center, int power, int layer, bool dirtyOnly)
+{
+	int sizeX = _save->getMapSizeX(), sizeY = _save->getMapSizeY();
+	std::vector<int> &light = _save->getTileStore()->light[layer];
+	const std::vector<LightStamp> &stamp = getLightStamp(power);
+	for (std::vector<LightStamp>::const_iterator i = stamp.begin(); i != stamp.end(); ++i)
+	{
+		int x = center.x + i->x;
+		int y = center.y + i->y;
+		if (x < 0 || x >= sizeX || y < 0 || y >= sizeY || (dirtyOnly && !_lightDirty[y * sizeX + x]))
+		{
+			continue;
+		}
+		for (int z = 0; z < _save->getMapSizeZ(); z++)
+		{
+			int &current = light[z * sizeX * sizeY + y * sizeX + x];
+			current = std::max(current, i->light);
+		}
+	}
 }
 
 /**
@@ -226,13 +380,28 @@ void TileEngine::addLight(Position center, int power, int layer)
  * @return True when new aliens are spotted.
  */
 bool TileEngine::calculateFOV(BattleUnit *unit)
+{
+	return calculateFOV(unit, true, unit->getPosition(), -1);
+}
+
+/**
+ * Calculates line of sight of a soldier.
+ * Visible units are always recalculated. Tile discovery can be skipped when only units
+ * or lighting changed, or limited to the tiles whose line of sight passes through
+ * an area where the terrain changed.
+ * @param unit Unit to check line of sight of.
+ * @param updateTiles Recalculate tile visibility and discovery?
+ * @param eventPos Center of the changed area.
+ * @param eventRadius Radius of the changed area, or -1 to re-trace every tile.
+ * @return True when new aliens are spotted.
+ */
+bool TileEngine::calculateFOV(BattleUnit *unit, bool updateTiles, Position eventPos, int eventRadius)
 {
 	size_t oldNumVisibleUnits = unit->getUnitsSpottedThisTurn().size();
 	Position center = unit->getPosition();
 	Position test;
 	int direction;
 	bool swap;
-	std::vector<Position> _trajectory;
 	if (Options::strafe && (unit->getTurretType() > -1)) {
 		direction = unit->getTurretDirection();
 	}
@@ -260,6 +429,7 @@ bool TileEngine::calculateFOV(BattleUnit *unit)
 			++pos.z;
 		}
 	}
+	_sightTargets.clear();
 	for (int x = 0; x <= MAX_VIEW_DISTANCE; ++x)
 	{
 		if (direction%2)
@@ -305,36 +475,9 @@ bool TileEngine::calculateFOV(BattleUnit *unit)
 							}
 						}
 
-						if (unit->getFaction() == FACTION_PLAYER)
+						if (unit->getFaction() == FACTION_PLAYER && updateTiles && (eventRadius < 0 || crossesArea(center, test, eventPos, eventRadius + 2)))
 						{
-							// this sets tiles to discovered if they are in LOS - tile visibility is not calculated in voxelspace but in tilespace
-							// large units have "4 pair of eyes"
-							int size = unit->getArmor()->getSize();
-							for (int xo = 0; xo < size; xo++)
-							{
-								for (int yo = 0; yo < size; yo++)
-								{
-									Position poso = pos + Position(xo,yo,0);
-									_trajectory.clear();
-									int tst = calculateLine(poso, test, true, &_trajectory, unit, false);
-									size_t tsize = _trajectory.size();
-									if (tst>127) --tsize; //last tile is blocked thus must be cropped
-									for (size_t i = 0; i < tsize; i++)
-									{
-										Position posi = _trajectory.at(i);
-										//mark every tile of line as visible (as in original)
-										//this is needed because of bresenham narrow stroke.
-										_save->getTile(posi)->setVisible(+1);
-										_save->getTile(posi)->setDiscovered(true, 2);
-										// walls to the east or south of a visible tile, we see that too
-										Tile* t = _save->getTile(Position(posi.x + 1, posi.y, posi.z));
-										if (t) t->setDiscovered(true, 0);
-										t = _save->getTile(Position(posi.x, posi.y + 1, posi.z));
-										if (t) t->setDiscovered(true, 1);
-									}
-
-								}
-							}
+							_sightTargets.push_back(test);
 						}
 					}
 				}
@@ -342,6 +485,27 @@ bool TileEngine::calculateFOV(BattleUnit *unit)
 		}
 	}
 
+	if (!_sightTargets.empty())
+	{
+		// this sets tiles to discovered if they are in LOS - tile visibility is not calculated in voxelspace but in tilespace
+		// large units have "4 pair of eyes"
+		int size = unit->getArmor()->getSize();
+		std::vector<int> seen;
+		for (int xo = 0; xo < size; xo++)
+		{
+			for (int yo = 0; yo < size; yo++)
+			{
+				Position poso = pos + Position(xo,yo,0);
+				seen.clear();
+				traceLinesOfSight(poso, unit, seen);
+				for (std::vector<int>::iterator i = seen.begin(); i != seen.end(); ++i)
+				{
+					discoverTile(*i);
+				}
+			}
+		}
+	}
+
 	// we only react when there are at least the same amount of visible units as before AND the checksum is different
 	// this way we stop if there are the same amount of visible units, but a different unit is seen
 	// or we stop if there are more visible units seen
@@ -549,6 +713,24 @@ bool TileEngine::canTargetUnit(Position *originVoxel, Tile *tile, Position *scan
 
 	if (potentialUnit == excludeUnit) return false; //skip self
 
+	// the obstacles have to be marked on the map, so those checks are always traced.
+	bool caching = _lofCacheDepth > 0 && !rememberObstacles;
+	LofKey key;
+	if (caching)
+	{
+		key.origin = *originVoxel;
+		key.tile = _save->getTileIndex(tile->getPosition());
+		key.part = hypothetical ? -2 : -1;
+		key.excludeUnit = excludeUnit;
+		key.potentialUnit = potentialUnit;
+		const LofResult *cached = findLof(key);
+		if (cached)
+		{
+			*scanVoxel = cached->scanVoxel;
+			return cached->hit;
+		}
+	}
+
 	int targetMinHeight = targetVoxel.z - tile->getTerrainLevel();
 	targetMinHeight += potentialUnit->getFloatHeight();
 
@@ -611,6 +793,7 @@ bool TileEngine::canTargetUnit(Position *originVoxel, Tile *tile, Position *scan
 							_trajectory.at(0).z >= targetMinHeight &&
 							_trajectory.at(0).z <= targetMaxHeight)
 						{
+							if (caching) addLof(key, true, *scanVoxel);
 							return true;
 						}
 					}
@@ -618,6 +801,7 @@ bool TileEngine::canTargetUnit(Position *originVoxel, Tile *tile, Position *scan
 			}
 			else if (test == V_EMPTY && hypothetical && !_trajectory.empty())
 			{
+				if (caching) addLof(key, true, *scanVoxel);
 				return true;
 			}
 			if (rememberObstacles && _trajectory.size()>0)
@@ -627,6 +811,7 @@ bool TileEngine::canTargetUnit(Position *originVoxel, Tile *tile, Position *scan
 			}
 		}
 	}
+	if (caching) addLof(key, false, *scanVoxel);
 	return false;
 }
 
@@ -775,6 +960,24 @@ bool TileEngine::canTargetTile(Position *originVoxel, Tile *tile, int part, Posi
 	if (rangeZ>10) rangeZ = 10; //as above, clamping height range to prevent buffer overflow
 	int centerZ = (maxZ + minZ)/2;
 
+	// the obstacles have to be marked on the map, so those checks are always traced.
+	bool caching = _lofCacheDepth > 0 && !rememberObstacles;
+	LofKey key;
+	if (caching)
+	{
+		key.origin = *originVoxel;
+		key.tile = _save->getTileIndex(tile->getPosition());
+		key.part = part;
+		key.excludeUnit = excludeUnit;
+		key.potentialUnit = 0;
+		const LofResult *cached = findLof(key);
+		if (cached)
+		{
+			*scanVoxel = cached->scanVoxel;
+			return cached->hit;
+		}
+	}
+
 	for (int j = 0; j <= rangeZ; ++j)
 	{
 		scanVoxel->z = targetVoxel.z + centerZ + heightFromCenter[j];
@@ -790,6 +993,7 @@ bool TileEngine::canTargetTile(Position *originVoxel, Tile *tile, int part, Posi
 					_trajectory.at(0).y/16 == scanVoxel->y/16 &&
 					_trajectory.at(0).z/24 == scanVoxel->z/24)
 				{
+					if (caching) addLof(key, true, *scanVoxel);
 					return true;
 				}
 			}
@@ -800,23 +1004,210 @@ bool TileEngine::canTargetTile(Position *originVoxel, Tile *tile, int part, Posi
 			}
 		}
 	}
+	if (caching) addLof(key, false, *scanVoxel);
 	return false;
 }
 
 /**
- * Calculates line of sight of a soldiers within range of the Position
- * (used when terrain has changed, which can reveal new parts of terrain or units).
- * @param position Position of the changed terrain.
+ * Starts caching the results of canTargetUnit() and canTargetTile(), for the
+ * duration of a single decision (reaction fire check, AI turn) that asks the
+ * same questions again and again. Calls can be nested; the cache is emptied
+ * when the outermost one begins, and whenever the terrain or the units on the
+ * map change in the meantime.
+ */
+void TileEngine::beginLofCache()
+{
+	if (_lofCacheDepth++ == 0)
+	{
+		_lofCache.clear();
+		_lofCacheChanges = _save->getTileStore()->changes;
+		_lofCacheLookups = 0;
+		_lofCacheHits = 0;
+	}
+}
+
+/**
+ * Stops caching line of fire checks, once the outermost caller is done.
+ * Reports how useful the cache was in the debug log.
+ */
+void TileEngine::endLofCache()
+{
+	if (_lofCacheDepth > 0 && --_lofCacheDepth == 0)
+	{
+		if (_lofCacheLookups > 0)
+		{
+			Log(LOG_DEBUG) << "LOF cache: " << _lofCacheHits << " hits out of " << _lofCacheLookups << " checks (" << (_lofCacheHits * 100 / _lofCacheLookups) << "%)";
+		}
+		_lofCache.clear();
+	}
+}
+
+/**
+ * Looks up a line of fire check in the cache, dropping the cached
+ * results first if the map has changed since they were traced.
+ * @param key The check to look up.
+ * @return The cached result, or 0 if it has to be traced.
+ */
+const TileEngine::LofResult *TileEngine::findLof(const LofKey &key)
+{
+	if (_lofCacheChanges != _save->getTileStore()->changes)
+	{
+		_lofCache.clear();
+		_lofCacheChanges = _save->getTileStore()->changes;
+	}
+	++_lofCacheLookups;
+	std::map<LofKey, LofResult>::const_iterator i = _lofCache.find(key);
+	if (i == _lofCache.end())
+	{
+		return 0;
+	}
+	++_lofCacheHits;
+	return &i->second;
+}
+
+/**
+ * Stores the result of a line of fire check in the cache.
+ * @param key The check that was traced.
+ * @param hit Whether the target can be hit.
+ * @param scanVoxel The voxel that was aimed at last.
+ */
+void TileEngine::addLof(const LofKey &key, bool hit, Position scanVoxel)
+{
+	LofResult &result = _lofCache[key];
+	result.hit = hit;
+	result.scanVoxel = scanVoxel;
+}
+
+/**
+ * Calculates line of sight of soldiers within range of the Position
+ * (used when terrain, lighting or units have changed, which can reveal new parts of terrain or units).
+ * Only units whose view cone reaches the changed area are updated, and of those only
+ * the tiles seen through the area are re-traced. Units standing on the position
+ * itself (a unit that just moved or changed sides) are recalculated completely.
+ * @param position Position of the change.
+ * @param eventRadius How far around the position things have changed.
+ * @param updateTiles Did the terrain change, so tile discovery has to be updated too?
  */
-void TileEngine::calculateFOV(Position position)
+void TileEngine::calculateFOV(Position position, int eventRadius, bool updateTiles)
 {
 	for (std::vector<BattleUnit*>::iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
 	{
-		if (distanceSq(position, (*i)->getPosition()) <= MAX_VIEW_DISTANCE_SQR)
+		if ((*i)->getPosition() == position)
 		{
 			calculateFOV(*i);
 		}
+		else if (distanceSq(position, (*i)->getPosition()) <= MAX_VIEW_DISTANCE_SQR && inViewCone(*i, position, eventRadius))
+		{
+			calculateFOV(*i, updateTiles, position, eventRadius);
+		}
+	}
+}
+
+/**
+ * Finds the tiles seen from an eye by tracing a separate line to every tile in _sightTargets.
+ * Tiles are added once for every line crossing them, as each line marks them visible.
+ * @param eye Position of the eye.
+ * @param unit The unit looking.
+ * @param seen Indexes of the tiles seen are added to this.
+ */
+void TileEngine::traceLinesOfSight(Position eye, BattleUnit *unit, std::vector<int> &seen)
+{
+	std::vector<Position> trajectory;
+	for (std::vector<Position>::iterator i = _sightTargets.begin(); i != _sightTargets.end(); ++i)
+	{
+		trajectory.clear();
+		int tst = calculateLine(eye, *i, true, &trajectory, unit, false);
+		size_t tsize = trajectory.size();
+		if (tst>127) --tsize; //last tile is blocked thus must be cropped
+		for (size_t j = 0; j < tsize; j++)
+		{
+			seen.push_back(_save->getTileIndex(trajectory.at(j)));
+		}
+	}
+}
+
+/**
+ * Marks a tile as visible and discovered.
+ * @param index Index of the tile.
+ */
+void TileEngine::discoverTile(int index)
+{
+	Tile *tile = _save->getTiles()[index];
+	Position pos = tile->getPosition();
+	//mark every tile of line as visible (as in original)
+	//this is needed because of bresenham narrow stroke.
+	tile->setVisible(+1);
+	tile->setDiscovered(true, 2);
+	// walls to the east or south of a visible tile, we see that too
+	Tile* t = _save->getTile(Position(pos.x + 1, pos.y, pos.z));
+	if (t) t->setDiscovered(true, 0);
+	t = _save->getTile(Position(pos.x, pos.y + 1, pos.z));
+	if (t) t->setDiscovered(true, 1);
+}
+
+/**
+ * Checks if any tile within a radius of a position can lie in a unit's view cone.
+ * This is a conservative test: it may say yes for areas just outside the cone.
+ * @param unit The watcher.
+ * @param pos Center of the area.
+ * @param radius Radius of the area.
+ * @return True if the area may be seen.
+ */
+bool TileEngine::inViewCone(BattleUnit *unit, Position pos, int radius) const
+{
+	int direction;
+	if (Options::strafe && (unit->getTurretType() > -1))
+	{
+		direction = unit->getTurretDirection();
+	}
+	else
+	{
+		direction = unit->getDirection();
 	}
+	// the same cone calculateFOV() sweeps, in coordinates along (forward) and across (side) the view direction
+	int signX[8] = { +1, +1, +1, +1, -1, -1, -1, -1 };
+	int signY[8] = { -1, -1, -1, +1, +1, +1, -1, -1 };
+	bool swap = (direction==0 || direction==4);
+	int dx = (pos.x - unit->getPosition().x) * signX[direction];
+	int dy = (pos.y - unit->getPosition().y) * signY[direction];
+	int forward = swap ? dy : dx;
+	int side = swap ? dx : dy;
+	// large units see from all of their tiles
+	int slack = radius + unit->getArmor()->getSize() - 1;
+	if (direction % 2)
+	{
+		return forward >= -slack && side >= -slack;
+	}
+	return forward >= -slack && abs(side) <= forward + 2 * slack;
+}
+
+/**
+ * Checks if the line of sight from a viewer to a tile passes close to an area.
+ * Only looks at the map horizontally, which is enough because the area covers all levels.
+ * @param origin The viewer's position.
+ * @param target The tile seen.
+ * @param center Center of the area.
+ * @param radius Radius of the area.
+ * @return True if the line comes within radius of the center.
+ */
+bool TileEngine::crossesArea(Position origin, Position target, Position center, int radius)
+{
+	int lx = target.x - origin.x, ly = target.y - origin.y;
+	int cx = center.x - origin.x, cy = center.y - origin.y;
+	int lengthSq = lx * lx + ly * ly;
+	int dot = cx * lx + cy * ly;
+	if (lengthSq == 0 || dot <= 0)
+	{
+		return cx * cx + cy * cy <= radius * radius;
+	}
+	if (dot >= lengthSq)
+	{
+		int ex = center.x - target.x, ey = center.y - target.y;
+		return ex * ex + ey * ey <= radius * radius;
+	}
+	// squared distance from the line, scaled by the squared length of the line
+	int cross = cx * ly - cy * lx;
+	return (double)cross * cross <= (double)radius * radius * lengthSq;
 }
 
 /**
@@ -882,7 +1273,10 @@ std::vector<std::pair<BattleUnit *, int> > TileEngine::getSpottingUnits(BattleUn
 	// no reaction on civilian turn.
 	if (_save->getSide() != FACTION_NEUTRAL)
 	{
-		for (std::vector<BattleUnit*>::const_iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
+		beginLofCache();
+		std::vector<BattleUnit*> candidates;
+		_save->getUnitsInRange(unit->getPosition(), MAX_VIEW_DISTANCE, candidates, _save->getSide());
+		for (std::vector<BattleUnit*>::const_iterator i = candidates.begin(); i != candidates.end(); ++i)
 		{
 				// not dead/unconscious
 			if (!(*i)->isOut() &&
@@ -942,6 +1336,7 @@ std::vector<std::pair<BattleUnit *, int> > TileEngine::getSpottingUnits(BattleUn
 				}
 			}
 		}
+		endLofCache();
 	}
 	return spotters;
 }
@@ -1128,6 +1523,7 @@ BattleUnit *TileEngine::hit(Position center, int power, ItemDamageType type, Bat
 		{
 			_save->addDestroyedObjective();
 		}
+		_save->getPathfinding()->invalidateTerrain(tile->getPosition());
 	}
 	else if (part == V_UNIT)
 	{
@@ -1216,8 +1612,18 @@ void TileEngine::explode(Position center, int power, ItemDamageType type, int ma
 	int hitSide = 0;
 	int diagonalWall = 0;
 	int power_;
-	std::set<Tile*> tilesAffected;
-	std::pair<std::set<Tile*>::iterator,bool> ret;
+	std::vector<Tile*> tilesAffected;
+
+	if ((int)_explosionStamp.size() != _save->getMapSizeXYZ())
+	{
+		_explosionStamp.assign(_save->getMapSizeXYZ(), 0);
+		_explosionGeneration = 0;
+	}
+	if (++_explosionGeneration == 0)
+	{
+		std::fill(_explosionStamp.begin(), _explosionStamp.end(), 0);
+		_explosionGeneration = 1;
+	}
 
 	if (type == DT_IN)
 	{
@@ -1256,10 +1662,10 @@ void TileEngine::explode(Position center, int power, ItemDamageType type, int ma
 		// raytrace every 3 degrees makes sure we cover all tiles in a circle.
 		for (int te = 0; te <= 360; te += 3)
 		{
-			double cos_te = cos(Deg2Rad(te));
-			double sin_te = sin(Deg2Rad(te));
-			double sin_fi = sin(Deg2Rad(fi));
-			double cos_fi = cos(Deg2Rad(fi));
+			double cos_te = explosionRays.cosTe[te / 3];
+			double sin_te = explosionRays.sinTe[te / 3];
+			double sin_fi = explosionRays.sinFi[(fi + 90) / 5];
+			double cos_fi = explosionRays.cosFi[(fi + 90) / 5];
 
 			origin = _save->getTile(Position(centerX, centerY, centerZ));
 			dest = origin;
@@ -1276,9 +1682,11 @@ void TileEngine::explode(Position center, int power, ItemDamageType type, int ma
 						dest->setExplosive(power_, 0);
 					}
 
-					ret = tilesAffected.insert(dest); // check if we had this tile already
-					if (ret.second)
+					int index = _save->getTileIndex(dest->getPosition());
+					if (_explosionStamp[index] != _explosionGeneration) // check if we had this tile already
 					{
+						_explosionStamp[index] = _explosionGeneration;
+						tilesAffected.push_back(dest);
 						int min = power_ * (100 - dmgRng) / 100;
 						int max = power_ * (100 + dmgRng) / 100;
 						BattleUnit *bu = dest->getUnit();
@@ -1460,11 +1868,21 @@ void TileEngine::explode(Position center, int power, ItemDamageType type, int ma
 			}
 		}
 	}
+	// keep the order the tiles used to be detonated in
+	std::sort(tilesAffected.begin(), tilesAffected.end());
+
+	// how far from the center things changed, for the FOV update
+	int affectedRadius = 1;
+	for (std::vector<Tile*>::iterator i = tilesAffected.begin(); i != tilesAffected.end(); ++i)
+	{
+		affectedRadius = std::max(affectedRadius, distance(center / Position(16,16,24), (*i)->getPosition()) + 1);
+	}
+
 	// now detonate the tiles affected with HE
 
 	if (type == DT_HE)
 	{
-		for (std::set<Tile*>::iterator i = tilesAffected.begin(); i != tilesAffected.end(); ++i)
+		for (std::vector<Tile*>::iterator i = tilesAffected.begin(); i != tilesAffected.end(); ++i)
 		{
 			if (detonate(*i))
 			{
@@ -1479,7 +1897,7 @@ void TileEngine::explode(Position center, int power, ItemDamageType type, int ma
 
 	calculateSunShading(); // roofs could have been destroyed
 	calculateTerrainLighting(); // fires could have been started
-	calculateFOV(center / Position(16,16,24));
+	calculateFOV(center / Position(16,16,24), affectedRadius);
 }
 
 /**
@@ -1565,6 +1983,7 @@ bool TileEngine::detonate(Tile* tile)
 				currentpart2 = currentpart;
 			if (tiles[i]->destroy(currentpart, _save->getObjectiveType()))
 				objective = true;
+			_save->getPathfinding()->invalidateTerrain(tiles[i]->getPosition());
 			currentpart =  currentpart2;
 			if (tiles[i]->getMapData(currentpart)) // take new values
 			{
@@ -2101,6 +2520,10 @@ int TileEngine::unitOpensDoor(BattleUnit *unit, bool rClick, int dir)
 					if (door != -1)
 					{
 						part = i->second;
+						if (door == 0 || door == 1)
+						{
+							_save->getPathfinding()->invalidateTerrain(tile->getPosition());
+						}
 						if (door == 1)
 						{
 							checkAdjacentDoors(unit->getPosition() + Position(x,y,z) + i->first, i->second);
@@ -2165,7 +2588,10 @@ void TileEngine::checkAdjacentDoors(const Position& pos, TilePart part)
 		Tile *tile = _save->getTile(pos + offset);
 		if (tile && tile->getMapData(part) && tile->getMapData(part)->isUFODoor())
 		{
-			tile->openDoor(part);
+			if (tile->openDoor(part) == 1)
+			{
+				_save->getPathfinding()->invalidateTerrain(tile->getPosition());
+			}
 		}
 		else break;
 	}
@@ -2175,7 +2601,10 @@ void TileEngine::checkAdjacentDoors(const Position& pos, TilePart part)
 		Tile *tile = _save->getTile(pos + offset);
 		if (tile && tile->getMapData(part) && tile->getMapData(part)->isUFODoor())
 		{
-			tile->openDoor(part);
+			if (tile->openDoor(part) == 1)
+			{
+				_save->getPathfinding()->invalidateTerrain(tile->getPosition());
+			}
 		}
 		else break;
 	}
@@ -2204,7 +2633,11 @@ int TileEngine::closeUfoDoors()
 				continue;
 			}
 		}
-		doorsclosed += _save->getTiles()[i]->closeUfoDoor();
+		if (_save->getTiles()[i]->closeUfoDoor())
+		{
+			_save->getPathfinding()->invalidateTerrain(_save->getTiles()[i]->getPosition());
+			++doorsclosed;
+		}
 	}
 
 	return doorsclosed;
@@ -2239,6 +2672,24 @@ int TileEngine::calculateLine(Position origin, Position target, bool storeTrajec
 		excludeAllUnits = true; // don't start unit spotting before pre-game inventory stuff (large units on the craftInventory tile will cause a crash if they're "spotted")
 	}
 
+	if (doVoxelCheck && Options::debug && Options::traceLOF && !_checkingLine)
+	{
+		// check skipping empty tiles against stepping through every voxel
+		std::vector<Position> reference;
+		size_t start = trajectory ? trajectory->size() : 0;
+		_checkingLine = true;
+		_skipEmptyTiles = false;
+		int expected = calculateLine(origin, target, storeTrajectory, &reference, excludeUnit, doVoxelCheck, onlyVisible, excludeAllBut);
+		_skipEmptyTiles = true;
+		result = calculateLine(origin, target, storeTrajectory, trajectory, excludeUnit, doVoxelCheck, onlyVisible, excludeAllBut);
+		_checkingLine = false;
+		if (result != expected || (trajectory && (trajectory->size() - start != reference.size() || !std::equal(reference.begin(), reference.end(), trajectory->begin() + start))))
+		{
+			Log(LOG_INFO) << "Line from " << origin << " to " << target << " hit " << result << " instead of " << expected;
+		}
+		return result;
+	}
+
 	//start and end points
 	x0 = origin.x;	 x1 = target.x;
 	y0 = origin.y;	 y1 = target.y;
@@ -2296,9 +2747,41 @@ int TileEngine::calculateLine(Position origin, Position target, bool storeTrajec
 			trajectory->push_back(Position(cx, cy, cz));
 		}
 		//passes through this point?
-		if (doVoxelCheck)
+		if (doVoxelCheck && _skipEmptyTiles && isVoxelTileEmpty(Position(cx, cy, cz)))
+		{
+			// nothing to hit anywhere in this tile, so skip ahead to the last point of the line inside it
+			if (!storeTrajectory && x != x1)
+			{
+				Position tile = Position(cx, cy, cz) / Position(16, 16, 24);
+				int lo[3] = { tile.x * 16, tile.y * 16, tile.z * 24 };
+				int hi[3] = { lo[0] + 15, lo[1] + 15, lo[2] + 23 };
+				if (swap_xy) { std::swap(lo[0], lo[1]); std::swap(hi[0], hi[1]); }
+				if (swap_xz) { std::swap(lo[0], lo[2]); std::swap(hi[0], hi[2]); }
+				// how many steps until the line leaves the tile along each axis, or ends
+				int tileSteps = std::min(abs(x1 - x), step_x > 0 ? hi[0] - x : x - lo[0]);
+				if (delta_y) tileSteps = std::min(tileSteps, ((step_y > 0 ? hi[1] - y : y - lo[1]) * delta_x + drift_xy) / delta_y);
+				if (delta_z) tileSteps = std::min(tileSteps, ((step_z > 0 ? hi[2] - z : z - lo[2]) * delta_x + drift_xz) / delta_z);
+				if (tileSteps > 1)
+				{
+					// take all but the last of those steps at once, the drift works out exactly as if stepping one by one
+					int skip = tileSteps - 1;
+					int skip_y = std::max(0, (skip * delta_y - drift_xy + delta_x - 1) / delta_x);
+					int skip_z = std::max(0, (skip * delta_z - drift_xz + delta_x - 1) / delta_x);
+					x += step_x * skip;
+					y += step_y * skip_y;
+					z += step_z * skip_z;
+					drift_xy += skip_y * delta_x - skip * delta_y;
+					drift_xz += skip_z * delta_x - skip * delta_z;
+				}
+			}
+		}
+		else if (doVoxelCheck)
 		{
 			result = voxelCheck(Position(cx, cy, cz), excludeUnit, false, onlyVisible, excludeAllBut);
+			if (_checkingLine && result != V_EMPTY && isVoxelTileEmpty(Position(cx, cy, cz)))
+			{
+				Log(LOG_INFO) << "Voxel " << Position(cx, cy, cz) << " hit " << result << " in a tile taken as empty";
+			}
 			if (result != V_EMPTY)
 			{
 				if (trajectory)
@@ -2548,11 +3031,6 @@ VoxelType TileEngine::voxelCheck(Position voxel, BattleUnit *excludeUnit, bool e
 		_cacheTileBelow = tileBelow;
  	}
 
-	if (tile->isVoid() && tile->getUnit() == 0 && (!tileBelow || tileBelow->getUnit() == 0))
-	{
-		return V_EMPTY;
-	}
-
 	if (tile->getMapData(O_FLOOR) && tile->getMapData(O_FLOOR)->isGravLift() && (voxel.z % 24 == 0 || voxel.z % 24 == 1))
 	{
 		if (!(tileBelow && tileBelow->getMapData(O_FLOOR) && tileBelow->getMapData(O_FLOOR)->isGravLift()))
@@ -2561,21 +3039,31 @@ VoxelType TileEngine::voxelCheck(Position voxel, BattleUnit *excludeUnit, bool e
 		}
 	}
 
+	const Uint16 *terrain = getTerrainVoxels(_save->getTileIndex(pos));
+	if (terrain == 0 && tile->getUnit() == 0 && (!tileBelow || tileBelow->getUnit() == 0))
+	{
+		return V_EMPTY;
+	}
+
 	// first we check terrain voxel data, not to allow 2x2 units stick through walls
-	for (int i = V_FLOOR; i <= V_OBJECT; ++i)
+	if (terrain && (terrain[((voxel.z%24)/2)*16 + voxel.y%16] & (1 << (15 - voxel.x%16))))
 	{
-		TilePart tp = (TilePart)i;
-		MapData *mp = tile->getMapData(tp);
-		if (((tp == O_WESTWALL) || (tp == O_NORTHWALL)) && tile->isUfoDoorOpen(tp))
-			continue;
-		if (mp != 0)
+		// something is here, find out which part it is
+		for (int i = V_FLOOR; i <= V_OBJECT; ++i)
 		{
-			int x = 15 - voxel.x%16;
-			int y = voxel.y%16;
-			int idx = (mp->getLoftID((voxel.z%24)/2)*16) + y;
-			if (_voxelData->at(idx) & (1 << x))
+			TilePart tp = (TilePart)i;
+			MapData *mp = tile->getMapData(tp);
+			if (((tp == O_WESTWALL) || (tp == O_NORTHWALL)) && tile->isUfoDoorOpen(tp))
+				continue;
+			if (mp != 0)
 			{
-				return (VoxelType)i;
+				int x = 15 - voxel.x%16;
+				int y = voxel.y%16;
+				int idx = (mp->getLoftID((voxel.z%24)/2)*16) + y;
+				if ((*_voxelData)[idx] & (1 << x))
+				{
+					return (VoxelType)i;
+				}
 			}
 		}
 	}
@@ -2622,7 +3110,7 @@ VoxelType TileEngine::voxelCheck(Position voxel, BattleUnit *excludeUnit, bool e
 					part = parts[tilepos.x - unitpos.x + (tilepos.y - unitpos.y)*2];
 				}
 				int idx = (unit->getLoftemps(part) * 16) + y;
-				if (_voxelData->at(idx) & (1 << x))
+				if ((*_voxelData)[idx] & (1 << x))
 				{
 					return V_UNIT;
 				}
@@ -2632,6 +3120,33 @@ VoxelType TileEngine::voxelCheck(Position voxel, BattleUnit *excludeUnit, bool e
 	return V_EMPTY;
 }
 
+/**
+ * Checks if nothing in the tile of a voxel can stop a line: no terrain voxels,
+ * no gravlift floor and no unit on it or reaching up into it from below.
+ * @param voxel The voxel.
+ * @return True if voxelCheck() would find nothing anywhere in the tile.
+ */
+bool TileEngine::isVoxelTileEmpty(Position voxel)
+{
+	if (voxel.x < 0 || voxel.y < 0 || voxel.z < 0)
+	{
+		return false;
+	}
+	Position pos = voxel / Position(16, 16, 24);
+	Tile *tile = _save->getTile(pos);
+	if (!tile || tile->getUnit())
+	{
+		return false;
+	}
+	// gravlift floors stop lines without any terrain voxels, see voxelCheck()
+	if (tile->getMapData(O_FLOOR) && tile->getMapData(O_FLOOR)->isGravLift())
+	{
+		return false;
+	}
+	Tile *tileBelow = _save->getTile(pos + Position(0,0,-1));
+	return (!tileBelow || !tileBelow->getUnit()) && getTerrainVoxels(_save->getTileIndex(pos)) == 0;
+}
+
 void TileEngine::voxelCheckFlush()
 {
 	_cacheTilePos = Position(-1,-1,-1);
@@ -2639,6 +3154,43 @@ void TileEngine::voxelCheckFlush()
 	_cacheTileBelow = 0;
 }
 
+/**
+ * Gets the terrain voxels of a tile, with all its parts combined into one bitmap,
+ * so voxelCheck() only has to look at the parts when something is hit.
+ * The bitmap is rebuilt when the tile's map data or ufo doors changed since it was last used.
+ * @param index Index of the tile.
+ * @return Pointer to 12 layers of 16 rows of voxels, or 0 if the tile has no terrain.
+ */
+const Uint16 *TileEngine::getTerrainVoxels(int index)
+{
+	TileStore *store = _save->getTileStore();
+	Uint16 *voxels = &store->voxels[index * TileStore::VOXEL_WORDS];
+	if (store->voxelState[index] == TileStore::VOXELS_DIRTY)
+	{
+		Tile *tile = _save->getTiles()[index];
+		std::fill(voxels, voxels + TileStore::VOXEL_WORDS, 0);
+		bool filled = false;
+		for (int i = O_FLOOR; i <= O_OBJECT; ++i)
+		{
+			TilePart tp = (TilePart)i;
+			MapData *mp = tile->getMapData(tp);
+			if (mp == 0 || (((tp == O_WESTWALL) || (tp == O_NORTHWALL)) && tile->isUfoDoorOpen(tp)))
+				continue;
+			for (int layer = 0; layer < 12; ++layer)
+			{
+				int loft = mp->getLoftID(layer) * 16;
+				for (int y = 0; y < 16; ++y)
+				{
+					voxels[layer * 16 + y] |= _voxelData->at(loft + y);
+					filled = filled || voxels[layer * 16 + y];
+				}
+			}
+		}
+		store->voxelState[index] = filled ? TileStore::VOXELS_FILLED : TileStore::VOXELS_EMPTY;
+	}
+	return store->voxelState[index] == TileStore::VOXELS_FILLED ? voxels : 0;
+}
+
 /**
  * Toggles personal lighting on / off.
  */
@@ -2847,7 +3399,7 @@ void TileEngine::itemDrop(Tile *t, BattleItem *item, const Mod* mod, bool newIte
 	if (item->getRules()->getBattleType() == BT_FLARE)
 	{
 		calculateTerrainLighting();
-		calculateFOV(p);
+		calculateFOV(p, item->getRules()->getPower(), false);
 	}
 }
 
@@ -18,6 +18,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <vector>
+#include <map>
 #include "Position.h"
 #include "../Mod/RuleItem.h"
 #include "../Mod/MapData.h"
@@ -38,19 +39,89 @@ struct BattleAction;
 class TileEngine
 {
 private:
-	static const int MAX_VIEW_DISTANCE = 20;
-	static const int MAX_VIEW_DISTANCE_SQR = MAX_VIEW_DISTANCE * MAX_VIEW_DISTANCE;
-	static const int MAX_VOXEL_VIEW_DISTANCE = MAX_VIEW_DISTANCE * 16;
+	/// A light source on one of the lighting layers.
+	struct LightSource
+	{
+		Position pos;
+		int power;
+		bool operator<(const LightSource &other) const { return pos.x != other.pos.x ? pos.x < other.pos.x : pos.y != other.pos.y ? pos.y < other.pos.y : pos.z != other.pos.z ? pos.z < other.pos.z : power < other.power; }
+		bool operator==(const LightSource &other) const { return pos == other.pos && power == other.power; }
+	};
+	/// One column lit by a light source, relative to the source.
+	struct LightStamp
+	{
+		int x, y, light;
+	};
+	/// A line of fire check: origin voxel, target tile and part, and the units involved.
+	struct LofKey
+	{
+		Position origin;
+		int tile, part;
+		BattleUnit *excludeUnit, *potentialUnit;
+		bool operator<(const LofKey &other) const
+		{
+			if (origin.x != other.origin.x) return origin.x < other.origin.x;
+			if (origin.y != other.origin.y) return origin.y < other.origin.y;
+			if (origin.z != other.origin.z) return origin.z < other.origin.z;
+			if (tile != other.tile) return tile < other.tile;
+			if (part != other.part) return part < other.part;
+			if (excludeUnit != other.excludeUnit) return excludeUnit < other.excludeUnit;
+			return potentialUnit < other.potentialUnit;
+		}
+	};
+	/// The outcome of a line of fire check.
+	struct LofResult
+	{
+		bool hit;
+		Position scanVoxel;
+	};
 	SavedBattleGame *_save;
 	std::vector<Uint16> *_voxelData;
 	static const int heightFromCenter[11];
-	void addLight(Position center, int power, int layer);
+	void addLight(Position center, int power, int layer, bool dirtyOnly = false);
+	std::vector< std::vector<LightStamp> > _lightStamps;
+	std::vector< std::vector<LightSource> > _lightSources;
+	std::vector<bool> _lightValid;
+	std::vector<char> _lightDirty;
+	/// Gets the columns lit by a light source of a certain power.
+	const std::vector<LightStamp> &getLightStamp(int power);
+	/// Relights the parts of a lighting layer where the light sources changed.
+	void applyLightSources(int layer, std::vector<LightSource> &sources);
 	int blockage(Tile *tile, const TilePart part, ItemDamageType type, int direction = -1, bool checkingFromOrigin = false);
 	bool _personalLighting;
 	Tile *_cacheTile;
 	Tile *_cacheTileBelow;
 	Position _cacheTilePos;
+	std::vector<Position> _sightTargets;
+	/// Calculates the field of view of a unit, optionally only re-tracing tiles seen through a changed area.
+	bool calculateFOV(BattleUnit *unit, bool updateTiles, Position eventPos, int eventRadius);
+	/// Checks if a unit's view cone can reach an area.
+	bool inViewCone(BattleUnit *unit, Position pos, int radius) const;
+	/// Checks if a line of sight passes close to an area.
+	bool crossesArea(Position origin, Position target, Position center, int radius);
+	/// Finds the tiles seen from an eye, tracing a separate line to each target.
+	void traceLinesOfSight(Position eye, BattleUnit *unit, std::vector<int> &seen);
+	/// Marks a tile and the walls next to it as seen.
+	void discoverTile(int index);
+	/// Gets the combined terrain voxels of a tile.
+	const Uint16 *getTerrainVoxels(int index);
+	bool _skipEmptyTiles, _checkingLine;
+	std::vector<unsigned int> _explosionStamp;
+	unsigned int _explosionGeneration;
+	/// Checks if a line can pass through the whole tile of a voxel.
+	bool isVoxelTileEmpty(Position voxel);
+	std::map<LofKey, LofResult> _lofCache;
+	int _lofCacheDepth;
+	unsigned int _lofCacheChanges;
+	int _lofCacheLookups, _lofCacheHits;
+	/// Looks up a line of fire check in the cache.
+	const LofResult *findLof(const LofKey &key);
+	/// Stores the result of a line of fire check in the cache.
+	void addLof(const LofKey &key, bool hit, Position scanVoxel);
 public:
+	static const int MAX_VIEW_DISTANCE = 20;
+	static const int MAX_VIEW_DISTANCE_SQR = MAX_VIEW_DISTANCE * MAX_VIEW_DISTANCE;
+	static const int MAX_VOXEL_VIEW_DISTANCE = MAX_VIEW_DISTANCE * 16;
 	static const int MAX_DARKNESS_TO_SEE_UNITS = 9;
 	/// Creates a new TileEngine class.
 	TileEngine(SavedBattleGame *save, std::vector<Uint16> *voxelData);
@@ -62,8 +133,8 @@ public:
 	void calculateSunShading(Tile *tile);
 	/// Calculates the field of view from a units view point.
 	bool calculateFOV(BattleUnit *unit);
-	/// Calculates the field of view within range of a certain position.
-	void calculateFOV(Position position);
+	/// Calculates the field of view of units that can see a changed area.
+	void calculateFOV(Position position, int eventRadius = 1, bool updateTiles = true);
 	/// Checks reaction fire.
 	bool checkReactionFire(BattleUnit *unit);
 	/// Recalculates lighting of the battlescape for terrain.
@@ -118,6 +189,10 @@ public:
 	bool canTargetUnit(Position *originVoxel, Tile *tile, Position *scanVoxel, BattleUnit *excludeUnit, bool rememberObstacles, BattleUnit *potentialUnit = 0);
 	/// Check validity for targetting a tile.
 	bool canTargetTile(Position *originVoxel, Tile *tile, int part, Position *scanVoxel, BattleUnit *excludeUnit, bool rememberObstacles);
+	/// Starts caching line of fire checks.
+	void beginLofCache();
+	/// Stops caching line of fire checks.
+	void endLofCache();
 	/// Calculates the z voxel for shadows.
 	int castedShade(Position voxel);
 	/// Checks the visibility of a given voxel.
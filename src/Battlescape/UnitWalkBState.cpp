@@ -198,7 +198,8 @@ void UnitWalkBState::think()
 			{
 				_unit->setVisible(false);
 			}
-			_terrain->calculateFOV(_unit->getPosition());
+			// only lighting and units changed, around us and as far as our personal light reaches
+			_terrain->calculateFOV(_unit->getPosition(), _unit->getFaction() == FACTION_PLAYER ? 16 : 1, false);
 			unitSpotted = (!_falling && !_action.desperate && _parent->getPanicHandled() && _numUnitsSpotted != _unit->getUnitsSpottedThisTurn().size());
 
 			if (_parent->checkForProximityGrenades(_unit))
@@ -1295,6 +1295,24 @@ std::string getExeFolder()
 	return std::string();
 }
 
+/**
+ * Gets how many processors the system has available,
+ * for spreading work over threads.
+ * @return Number of processors, at least 1.
+ */
+int getProcessorCount()
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return std::max(1, (int)info.dwNumberOfProcessors);
+#elif defined(_SC_NPROCESSORS_ONLN)
+	return std::max(1, (int)sysconf(_SC_NPROCESSORS_ONLN));
+#else
+	return 1;
+#endif
+}
+
 }
 
 }
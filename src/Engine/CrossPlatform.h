@@ -105,6 +105,8 @@ namespace CrossPlatform
 	bool openExplorer(const std::string &url);
 	/// Gets the path to the executable file.
 	std::string getExeFolder();
+	/// Gets the number of processors available.
+	int getProcessorCount();
 }
 
 }
@@ -21,6 +21,8 @@
 #include <algorithm>
 #include <cmath>
 #include <sstream>
+#include <chrono>
+#include <climits>
 #include <SDL_mixer.h>
 #include "State.h"
 #include "Screen.h"
@@ -36,6 +38,7 @@
 #include "Action.h"
 #include "Exception.h"
 #include "Options.h"
+#include "Timer.h"
 #include "CrossPlatform.h"
 #include "FileMap.h"
 #include "Unicode.h"
@@ -46,12 +49,23 @@ namespace OpenXcom
 
 const double Game::VOLUME_GRADIENT = 10.0;
 
+namespace
+{
+
+/// Gets a high resolution timestamp, in microseconds.
+Uint64 getMicroTicks()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}
+
 /**
  * Starts up all the SDL subsystems,
  * creates the display screen and sets up the cursor.
  * @param title Title of the game window.
  */
-Game::Game(const std::string &title) : _screen(0), _cursor(0), _lang(0), _save(0), _mod(0), _quit(false), _init(false), _mouseActive(true), _timeUntilNextFrame(0)
+Game::Game(const std::string &title) : _screen(0), _cursor(0), _lang(0), _save(0), _mod(0), _quit(false), _init(false), _mouseActive(true), _frameInterval(0)
 {
 	Options::reload = false;
 	Options::mute = false;
@@ -147,6 +161,8 @@ void Game::run()
 	static const ApplicationState stateRun[4] = { SLOWED, PAUSED, PAUSED, PAUSED };
 	// this will avoid processing SDL's resize event on startup, workaround for the heap allocation error it causes.
 	bool startupEvent = Options::allowResize;
+	// start timing from now so the first frame doesn't count the whole startup
+	_timeOfLastFrame = getMicroTicks();
 	while (!_quit)
 	{
 		// Clean up states
@@ -291,26 +307,27 @@ void Game::run()
 		// Process rendering
 		if (runningState != PAUSED)
 		{
-			// Process logic
+			// Process logic, and collect when the timers want to run next
+			Timer::resetDeadline();
 			_states.back()->think();
 			_fpsCounter->think();
 			if (Options::FPS > 0 && !(Options::useOpenGL && Options::vSyncForOpenGL))
 			{
 				// Update our FPS delay time based on the time of the last draw.
 				int fps = SDL_GetAppState() & SDL_APPINPUTFOCUS ? Options::FPS : Options::FPSInactive;
-
-				_timeUntilNextFrame = (1000.0f / fps) - (SDL_GetTicks() - _timeOfLastFrame);
+				_frameInterval = 1000000 / std::max(fps, 1);
 			}
 			else
 			{
-				_timeUntilNextFrame = 0;
+				_frameInterval = 0;
 			}
 
-			if (_init && _timeUntilNextFrame <= 0)
+			Uint64 now = getMicroTicks();
+			if (_init && (Sint64)(now - _timeOfLastFrame) >= _frameInterval)
 			{
 				// make a note of when this frame update occurred.
-				_timeOfLastFrame = SDL_GetTicks();
-				_fpsCounter->addFrame();
+				_fpsCounter->addFrame((Uint32)std::min(now - _timeOfLastFrame, (Uint64)UINT_MAX));
+				_timeOfLastFrame = now;
 				_screen->clear();
 				std::list<State*>::iterator i = _states.end();
 				do
@@ -332,8 +349,8 @@ void Game::run()
 		// Save on CPU
 		switch (runningState)
 		{
-			case RUNNING: 
-				SDL_Delay(1); //Save CPU from going 100%
+			case RUNNING:
+				waitForWork(); //Save CPU from going 100%
 				break;
 			case SLOWED: case PAUSED:
 				SDL_Delay(100); break; //More slowing down.
@@ -343,6 +360,32 @@ void Game::run()
 	Options::save();
 }
 
+/**
+ * Sleeps until there is something to do: the next frame is due,
+ * one of the running timers is due, or input has arrived.
+ * Sleeps at least a millisecond, and without a frame limit no
+ * longer than that, like the game always did.
+ */
+void Game::waitForWork()
+{
+	Sint64 wait = 1;
+	if (_frameInterval > 0)
+	{
+		Sint64 untilFrame = (_frameInterval - (Sint64)(getMicroTicks() - _timeOfLastFrame)) / 1000;
+		wait = std::min(untilFrame, (Sint64)Timer::getTimeToDeadline());
+	}
+	// sleep in short slices, so input still gets handled promptly.
+	SDL_Event event;
+	do
+	{
+		Sint64 slice = std::max((Sint64)1, std::min(wait, (Sint64)MAX_SLEEP));
+		SDL_Delay((Uint32)slice);
+		wait -= slice;
+		SDL_PumpEvents();
+	}
+	while (wait > 0 && SDL_PeepEvents(&event, 1, SDL_PEEKEVENT, SDL_ALLEVENTS) == 0);
+}
+
 /**
  * Stops the state machine and the game is shut down.
  */
@@ -51,9 +51,13 @@ private:
 	bool _quit, _init;
 	FpsCounter *_fpsCounter;
 	bool _mouseActive;
-	unsigned int _timeOfLastFrame;
-	int _timeUntilNextFrame;
+	Uint64 _timeOfLastFrame;
+	Sint64 _frameInterval;
 	static const double VOLUME_GRADIENT;
+	/// Longest time to sleep without checking for input, in milliseconds.
+	static const int MAX_SLEEP = 4;
+	/// Sleeps until the next frame, timer or input event.
+	void waitForWork();
 
 public:
 	/// Creates a new game and initializes SDL.
@@ -111,7 +111,7 @@ void Screen::makeVideoFlags()
  * Initializes a new display screen for the game to render contents to.
  * The screen is set up based on the current options.
  */
-Screen::Screen() : _baseWidth(ORIGINAL_WIDTH), _baseHeight(ORIGINAL_HEIGHT), _scaleX(1.0), _scaleY(1.0), _flags(0), _numColors(0), _firstColor(0), _pushPalette(false), _surface(0)
+Screen::Screen() : _baseWidth(ORIGINAL_WIDTH), _baseHeight(ORIGINAL_HEIGHT), _scaleX(1.0), _scaleY(1.0), _flags(0), _numColors(0), _firstColor(0), _pushPalette(false), _surface(0), _redrawAll(true)
 {
 	resetDisplay();
 	memset(deferredPalette, 0, 256*sizeof(SDL_Color));
@@ -143,6 +143,12 @@ Surface *Screen::getSurface()
  */
 void Screen::handle(Action *action)
 {
+	// the window contents were lost, show the whole frame again.
+	if (action->getDetails()->type == SDL_VIDEOEXPOSE)
+	{
+		_redrawAll = true;
+	}
+
 	if (Options::debug)
 	{
 		if (action->getDetails()->type == SDL_KEYDOWN && action->getDetails()->key.keysym.sym == SDLK_F8)
@@ -178,16 +184,81 @@ void Screen::handle(Action *action)
 }
 
 
+/**
+ * Compares the buffer against a copy of the last frame that was shown,
+ * and updates the copy.
+ * @param firstRow Returns the first row that changed.
+ * @param lastRow Returns the last row that changed.
+ * @return True if any row changed.
+ */
+bool Screen::findDamage(int *firstRow, int *lastRow)
+{
+	SDL_Surface *buffer = _surface->getSurface();
+	size_t rowSize = buffer->w * buffer->format->BytesPerPixel;
+	if (_lastFrame.size() != rowSize * buffer->h)
+	{
+		_lastFrame.assign(rowSize * buffer->h, 0);
+		_redrawAll = true;
+	}
+	*firstRow = -1;
+	*lastRow = -1;
+	for (int y = 0; y < buffer->h; ++y)
+	{
+		Uint8 *row = (Uint8*)buffer->pixels + y * buffer->pitch;
+		Uint8 *last = &_lastFrame[y * rowSize];
+		if (memcmp(row, last, rowSize) != 0)
+		{
+			memcpy(last, row, rowSize);
+			if (*firstRow == -1)
+			{
+				*firstRow = y;
+			}
+			*lastRow = y;
+		}
+	}
+	return *firstRow != -1;
+}
+
 /**
  * Renders the buffer's contents onto the screen, applying
  * any necessary filters or conversions in the process.
  * If the scaling factor is bigger than 1, the entire contents
  * of the buffer are resized by that factor (eg. 2 = doubled)
  * before being put on screen.
+ * Frames identical to the last one shown are skipped, and when
+ * the buffer is copied unscaled only the changed rows are updated.
  */
 void Screen::flip()
 {
-	if (getWidth() != _baseWidth || getHeight() != _baseHeight || useOpenGL())
+	int firstRow, lastRow;
+	bool damaged = findDamage(&firstRow, &lastRow);
+	bool zoom = getWidth() != _baseWidth || getHeight() != _baseHeight || useOpenGL();
+	// a vsynced buffer swap is what paces the frames, so keep doing it.
+	if (useOpenGL() && Options::vSyncForOpenGL)
+	{
+		_redrawAll = true;
+	}
+	if (!damaged && !_redrawAll)
+	{
+		return;
+	}
+
+	if (!zoom && !_redrawAll && !(_screen->flags & (SDL_HWSURFACE | SDL_DOUBLEBUF)))
+	{
+		SDL_Rect rect;
+		rect.x = 0;
+		rect.y = firstRow;
+		rect.w = getWidth();
+		rect.h = lastRow - firstRow + 1;
+		SDL_BlitSurface(_surface->getSurface(), &rect, _screen, &rect);
+		SDL_UpdateRect(_screen, rect.x, rect.y, rect.w, rect.h);
+		return;
+	}
+	_redrawAll = false;
+
+	if (_screen->flags & SDL_SWSURFACE) memset(_screen->pixels, 0, _screen->h*_screen->pitch);
+	else SDL_FillRect(_screen, &_clear, 0);
+	if (zoom)
 	{
 		Zoom::flipWithZoom(_surface->getSurface(), _screen, _topBlackBand, _bottomBlackBand, _leftBlackBand, _rightBlackBand, &glOutput);
 	}
@@ -221,8 +292,6 @@ void Screen::flip()
 void Screen::clear()
 {
 	_surface->clear();
-	if (_screen->flags & SDL_SWSURFACE) memset(_screen->pixels, 0, _screen->h*_screen->pitch);
-	else SDL_FillRect(_screen, &_clear, 0);
 }
 
 /**
@@ -249,6 +318,7 @@ void Screen::setPalette(SDL_Color* colors, int firstcolor, int ncolors, bool imm
 	}
 
 	_surface->setPalette(colors, firstcolor, ncolors);
+	_redrawAll = true;
 
 	// defer actual update of screen until SDL_Flip()
 	if (immediately && _screen->format->BitsPerPixel == 8 && SDL_SetColors(_screen, colors, firstcolor, ncolors) == 0)
@@ -314,6 +384,7 @@ void Screen::resetDisplay(bool resetVideo)
 	Uint32 oldFlags = _flags;
 #endif
 	makeVideoFlags();
+	_redrawAll = true;
 
 	if (!_surface || (_surface->getSurface()->format->BitsPerPixel != _bpp ||
 		_surface->getSurface()->w != _baseWidth ||
@@ -19,6 +19,7 @@
  */
 #include <SDL.h>
 #include <string>
+#include <vector>
 #include "OpenGL.h"
 
 namespace OpenXcom
@@ -50,6 +51,10 @@ private:
 	OpenGL glOutput;
 	Surface *_surface;
 	SDL_Rect _clear;
+	std::vector<Uint8> _lastFrame;
+	bool _redrawAll;
+	/// Finds the rows of the buffer that changed since the last frame was shown.
+	bool findDamage(int *firstRow, int *lastRow);
 	/// Sets the _flags and _bpp variables based on game options; needed in more than one place now
 	void makeVideoFlags();
 public:
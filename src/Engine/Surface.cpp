@@ -136,7 +136,7 @@ inline void DeleteAligned(void* buffer)
  * @param y Y position in pixels.
  * @param bpp Bits-per-pixel depth.
  */
-Surface::Surface(int width, int height, int x, int y, int bpp) : _x(x), _y(y), _visible(true), _hidden(false), _redraw(false), _tftdMode(false), _alignedBuffer(0)
+Surface::Surface(int width, int height, int x, int y, int bpp) : _x(x), _y(y), _visible(true), _hidden(false), _redraw(false), _tftdMode(false), _alignedBuffer(0), _cacheSpans(false)
 {
 	_alignedBuffer = NewAligned(bpp, width, height);
 	_surface = SDL_CreateRGBSurfaceFrom(_alignedBuffer, width, height, bpp, GetPitch(bpp, width), 0, 0, 0, 0);
@@ -202,6 +202,7 @@ Surface::Surface(const Surface& other)
 	_hidden = other._hidden;
 	_redraw = other._redraw;
 	_tftdMode = other._tftdMode;
+	_cacheSpans = other._cacheSpans;
 }
 
 /**
@@ -220,6 +221,7 @@ Surface::~Surface()
 template <typename T>
 void Surface::rawCopy(const std::vector<T> &src)
 {
+	_spanRows.clear();
 	// Copy whole thing
 	if (_surface->pitch == _surface->w)
 	{
@@ -291,6 +293,7 @@ void Surface::loadScr(const std::string &filename)
  */
 void Surface::loadImage(const std::string &filename)
 {
+	_spanRows.clear();
 	// Destroy current surface (will be replaced)
 	DeleteAligned(_alignedBuffer);
 	SDL_FreeSurface(_surface);
@@ -366,6 +369,7 @@ void Surface::loadImage(const std::string &filename)
  */
 void Surface::loadSpk(const std::string &filename)
 {
+	_spanRows.clear();
 	// Load file and put pixels in surface
 	std::ifstream imgFile (filename.c_str(), std::ios::in | std::ios::binary);
 	if (!imgFile)
@@ -422,6 +426,7 @@ void Surface::loadSpk(const std::string &filename)
  */
 void Surface::loadBdy(const std::string &filename)
 {
+	_spanRows.clear();
 	// Load file and put pixels in surface
 	std::ifstream imgFile (filename.c_str(), std::ios::in | std::ios::binary);
 	if (!imgFile)
@@ -477,6 +482,7 @@ void Surface::loadBdy(const std::string &filename)
  */
 void Surface::clear(Uint32 color)
 {
+	_spanRows.clear();
 	if (_surface->flags & SDL_SWSURFACE) memset(_surface->pixels, color, _surface->h*_surface->pitch);
 	else SDL_FillRect(_surface, &_clear, color);
 }
@@ -492,6 +498,7 @@ void Surface::clear(Uint32 color)
  */
 void Surface::offset(int off, int min, int max, int mul)
 {
+	_spanRows.clear();
 	if (off == 0)
 		return;
 
@@ -542,6 +549,7 @@ void Surface::offset(int off, int min, int max, int mul)
  */
 void Surface::offsetBlock(int off, int blk, int mul)
 {
+	_spanRows.clear();
 	if (off == 0)
 		return;
 
@@ -592,6 +600,7 @@ void Surface::offsetBlock(int off, int blk, int mul)
  */
 void Surface::invert(Uint8 mid)
 {
+	_spanRows.clear();
 	// Lock the surface
 	lock();
 
@@ -660,6 +669,7 @@ void Surface::blit(Surface *surface)
 		target.x = getX();
 		target.y = getY();
 		SDL_BlitSurface(_surface, cropper, surface->getSurface(), &target);
+		surface->_spanRows.clear();
 	}
 }
 
@@ -672,6 +682,7 @@ void Surface::blit(Surface *surface)
  */
 void Surface::copy(Surface *surface)
 {
+	_spanRows.clear();
 	/*
 	SDL_BlitSurface uses colour matching,
 	and is therefor unreliable as a means
@@ -880,6 +891,7 @@ void Surface::setHidden(bool hidden)
  */
 void Surface::lock()
 {
+	_spanRows.clear();
 	SDL_LockSurface(_surface);
 }
 
@@ -952,10 +964,182 @@ struct StandardShade
 
 
 
+namespace
+{
+
+/**
+ * Shades a source pixel by a fixed amount, so the compiler
+ * can fold the shade into the span loop.
+ */
+template <int Shade>
+struct SpanShade
+{
+	inline void operator()(Uint8& dest, Uint8 src) const
+	{
+		const int newShade = (src&15) + Shade;
+		dest = newShade > 15 ? 15 : (src&(15<<4)) | newShade;
+	}
+};
+
+/**
+ * Shades a source pixel by any amount, same as StandardShade.
+ */
+struct SpanAnyShade
+{
+	int shade;
+	inline void operator()(Uint8& dest, Uint8 src) const
+	{
+		const int newShade = (src&15) + shade;
+		dest = newShade > 15 ? 15 : (src&(15<<4)) | newShade;
+	}
+};
+
+/**
+ * Shades a source pixel and replaces its color, same as ColorReplace.
+ */
+struct SpanColorReplace
+{
+	int shade, newColor;
+	inline void operator()(Uint8& dest, Uint8 src) const
+	{
+		const int newShade = (src&15) + shade;
+		dest = newShade > 15 ? 15 : newColor | newShade;
+	}
+};
+
+/**
+ * Draws the opaque runs of a surface onto another one.
+ * Runs are stored as begin/end column pairs, row by row.
+ * @param spans Runs of all rows.
+ * @param rows Index of the first run of each row, plus one past the last row.
+ * @param src Source surface.
+ * @param dest Destination surface.
+ * @param x X offset of the source on the destination.
+ * @param y Y offset of the source on the destination.
+ * @param clip Area of the destination that can be drawn on.
+ * @param beginX First source column to draw.
+ * @param shader Pixel function.
+ */
+template <typename Shader>
+void blitSpans(const std::vector<Uint16> &spans, const std::vector<Uint32> &rows, const SDL_Surface *src, SDL_Surface *dest, int x, int y, const GraphSubset &clip, int beginX, Shader shader)
+{
+	const int firstRow = std::max(0, clip.beg_y - y);
+	const int lastRow = std::min((int)rows.size() - 1, clip.end_y - y);
+	const int minX = std::max(beginX, clip.beg_x - x);
+	const int maxX = clip.end_x - x;
+	if (minX >= maxX)
+	{
+		return;
+	}
+	for (int row = firstRow; row < lastRow; ++row)
+	{
+		const Uint8 *s = (const Uint8*)src->pixels + row * src->pitch;
+		Uint8 *d = (Uint8*)dest->pixels + (row + y) * dest->pitch;
+		for (Uint32 i = rows[row]; i < rows[row + 1]; i += 2)
+		{
+			const int end = std::min((int)spans[i + 1], maxX);
+			for (int sx = std::max((int)spans[i], minX); sx < end; ++sx)
+			{
+				shader(d[x + sx], s[sx]);
+			}
+		}
+	}
+}
+
+/**
+ * Gets the area of a surface that can be drawn on, see SDL_SetClipRect.
+ * @param surface SDL surface.
+ * @return Area in surface coordinates.
+ */
+inline GraphSubset getClip(const SDL_Surface *surface)
+{
+	const SDL_Rect &rect = surface->clip_rect;
+	return GraphSubset(std::make_pair((int)rect.x, rect.x + rect.w), std::make_pair((int)rect.y, rect.y + rect.h));
+}
+
+/**
+ * Picks the span loop specialized for the given shade.
+ * Battlescape shades are 0-15, anything else uses the generic loop.
+ */
+void blitShadedSpans(const std::vector<Uint16> &spans, const std::vector<Uint32> &rows, const SDL_Surface *src, SDL_Surface *dest, int x, int y, const GraphSubset &clip, int beginX, int shade)
+{
+	switch (shade)
+	{
+	case 0: blitSpans(spans, rows, src, dest, x, y, clip, beginX, SpanShade<0>()); break;
+	case 1: blitSpans(spans, rows, src, dest, x, y, clip, beginX, SpanShade<1>()); break;
+	case 2: blitSpans(spans, rows, src, dest, x, y, clip, beginX, SpanShade<2>()); break;
+	case 3: blitSpans(spans, rows, src, dest, x, y, clip, beginX, SpanShade<3>()); break;
+	case 4: blitSpans(spans, rows, src, dest, x, y, clip, beginX, SpanShade<4>()); break;
+	case 5: blitSpans(spans, rows, src, dest, x, y, clip, beginX, SpanShade<5>()); break;
+	case 6: blitSpans(spans, rows, src, dest, x, y, clip, beginX, SpanShade<6>()); break;
+	case 7: blitSpans(spans, rows, src, dest, x, y, clip, beginX, SpanShade<7>()); break;
+	case 8: blitSpans(spans, rows, src, dest, x, y, clip, beginX, SpanShade<8>()); break;
+	case 9: blitSpans(spans, rows, src, dest, x, y, clip, beginX, SpanShade<9>()); break;
+	case 10: blitSpans(spans, rows, src, dest, x, y, clip, beginX, SpanShade<10>()); break;
+	case 11: blitSpans(spans, rows, src, dest, x, y, clip, beginX, SpanShade<11>()); break;
+	case 12: blitSpans(spans, rows, src, dest, x, y, clip, beginX, SpanShade<12>()); break;
+	case 13: blitSpans(spans, rows, src, dest, x, y, clip, beginX, SpanShade<13>()); break;
+	case 14: blitSpans(spans, rows, src, dest, x, y, clip, beginX, SpanShade<14>()); break;
+	case 15: blitSpans(spans, rows, src, dest, x, y, clip, beginX, SpanShade<15>()); break;
+	default:
+		{
+			SpanAnyShade shader = { shade };
+			blitSpans(spans, rows, src, dest, x, y, clip, beginX, shader);
+		}
+		break;
+	}
+}
+
+}
+
+/**
+ * Lets shaded blits remember where the opaque pixels of this
+ * surface are, so transparent areas are skipped without being read.
+ * Only meant for sprites that don't change once loaded,
+ * the runs are rebuilt whenever the surface itself redraws its pixels.
+ * @param cache True to cache the runs.
+ */
+void Surface::setCacheSpans(bool cache)
+{
+	_cacheSpans = cache;
+	_spanRows.clear();
+}
+
+/**
+ * Scans the surface for runs of non-transparent pixels
+ * and stores them row by row for blitNShade.
+ */
+void Surface::buildSpans()
+{
+	_spans.clear();
+	_spanRows.clear();
+	_spanRows.reserve(getHeight() + 1);
+	for (int y = 0; y < getHeight(); ++y)
+	{
+		_spanRows.push_back(_spans.size());
+		const Uint8 *row = getRaw(0, y);
+		int x = 0;
+		while (x < getWidth())
+		{
+			while (x < getWidth() && row[x] == 0)
+				++x;
+			if (x == getWidth())
+				break;
+			const int begin = x;
+			while (x < getWidth() && row[x] != 0)
+				++x;
+			_spans.push_back(begin);
+			_spans.push_back(x);
+		}
+	}
+	_spanRows.push_back(_spans.size());
+}
+
 /**
  * Specific blit function to blit battlescape terrain data in different shades in a fast way.
  * Notice there is no surface locking here - you have to make sure you lock the surface yourself
  * at the start of blitting and unlock it when done.
+ * Pixels outside the target's SDL clipping rectangle are left alone.
  * @param surface to blit to
  * @param x
  * @param y
@@ -965,7 +1149,31 @@ struct StandardShade
  */
 void Surface::blitNShade(Surface *surface, int x, int y, int off, bool half, int newBaseColor)
 {
+	surface->_spanRows.clear();
+	if (_cacheSpans && _surface->format->BytesPerPixel == 1 && surface->_surface->format->BytesPerPixel == 1)
+	{
+		if (_spanRows.empty())
+		{
+			buildSpans();
+		}
+		// same as ShaderSurface, the target's position offsets the blit
+		const GraphSubset clip = getClip(surface->_surface);
+		const int beginX = half ? getWidth()/2 : 0;
+		if (newBaseColor)
+		{
+			SpanColorReplace shader = { off, (newBaseColor - 1) << 4 };
+			blitSpans(_spans, _spanRows, _surface, surface->_surface, x - surface->getX(), y - surface->getY(), clip, beginX, shader);
+		}
+		else
+		{
+			blitShadedSpans(_spans, _spanRows, _surface, surface->_surface, x - surface->getX(), y - surface->getY(), clip, beginX, off);
+		}
+		return;
+	}
+
 	ShaderMove<Uint8> src(this, x, y);
+	ShaderMove<Uint8> dest = ShaderSurface(surface);
+	dest.setDomain(getClip(surface->_surface));
 	if (half)
 	{
 		GraphSubset g = src.getDomain();
@@ -976,10 +1184,10 @@ void Surface::blitNShade(Surface *surface, int x, int y, int off, bool half, int
 	{
 		--newBaseColor;
 		newBaseColor <<= 4;
-		ShaderDraw<ColorReplace>(ShaderSurface(surface), src, ShaderScalar(off), ShaderScalar(newBaseColor));
+		ShaderDraw<ColorReplace>(dest, src, ShaderScalar(off), ShaderScalar(newBaseColor));
 	}
 	else
-		ShaderDraw<StandardShade>(ShaderSurface(surface), src, ShaderScalar(off));
+		ShaderDraw<StandardShade>(dest, src, ShaderScalar(off));
 
 }
 
@@ -993,10 +1201,22 @@ void Surface::blitNShade(Surface *surface, int x, int y, int off, bool half, int
  */
 void Surface::blitNShade(Surface *surface, int x, int y, int shade, GraphSubset range)
 {
+	surface->_spanRows.clear();
+	if (_cacheSpans && _surface->format->BytesPerPixel == 1 && surface->_surface->format->BytesPerPixel == 1)
+	{
+		if (_spanRows.empty())
+		{
+			buildSpans();
+		}
+		const GraphSubset clip = GraphSubset::intersection(range, getClip(surface->_surface));
+		blitShadedSpans(_spans, _spanRows, _surface, surface->_surface, x - surface->getX(), y - surface->getY(), clip, 0, shade);
+		return;
+	}
+
 	ShaderMove<Uint8> src(this, x, y);
 	ShaderMove<Uint8> dest(surface);
 
-	dest.setDomain(range);
+	dest.setDomain(GraphSubset::intersection(range, getClip(surface->_surface)));
 
 	ShaderDraw<StandardShade>(dest, src, ShaderScalar(shade));
 }
@@ -1039,6 +1259,7 @@ void Surface::setTooltip(const std::string &tooltip)
  */
 void Surface::resize(int width, int height)
 {
+	_spanRows.clear();
 	// Set up new surface
 	Uint8 bpp = _surface->format->BitsPerPixel;
 	int pitch = GetPitch(bpp, width);
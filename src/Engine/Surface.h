@@ -44,12 +44,17 @@ protected:
 	bool _visible, _hidden, _redraw, _tftdMode;
 	void *_alignedBuffer;
 	std::string _tooltip;
+	bool _cacheSpans;
+	std::vector<Uint16> _spans;
+	std::vector<Uint32> _spanRows;
 
 	/// Copies raw pixels.
 	template <typename T>
 	void rawCopy(const std::vector<T> &bytes);
 	/// Resizes the surface.
 	void resize(int width, int height);
+	/// Builds the list of opaque pixel runs.
+	void buildSpans();
 public:
 	/// Creates a new surface with the specified size and position.
 	Surface(int width, int height, int x = 0, int y = 0, int bpp = 8);
@@ -234,6 +239,8 @@ public:
 	void blitNShade(Surface *surface, int x, int y, int shade, bool half = false, int newBaseColor = 0);
 	/// Specific blit function to blit battlescape terrain data in different shades in a fast way.
 	void blitNShade(Surface *surface, int x, int y, int shade, GraphSubset range);
+	/// Sets whether shaded blits can cache the surface's opaque pixel runs.
+	void setCacheSpans(bool cache);
 	/// Invalidate the surface: force it to be redrawn
 	void invalidate(bool valid = true);
 	/// Gets the tooltip of the surface.
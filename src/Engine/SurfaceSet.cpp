@@ -104,12 +104,14 @@ void SurfaceSet::loadPck(const std::string &pck, const std::string &tab)
 		for (int frame = 0; frame < nframes; ++frame)
 		{
 			_frames[frame] = new Surface(_width, _height);
+			_frames[frame]->setCacheSpans(true);
 		}
 	}
 	else
 	{
 		nframes = 1;
 		_frames[0] = new Surface(_width, _height);
+		_frames[0]->setCacheSpans(true);
 	}
 
 	// Load PCK and put pixels in surfaces
@@ -188,6 +190,7 @@ void SurfaceSet::loadDat(const std::string &filename)
 	for (int i = 0; i < nframes; ++i)
 	{
 		Surface *surface = new Surface(_width, _height);
+		surface->setCacheSpans(true);
 		_frames[i] = surface;
 	}
 
@@ -227,9 +230,10 @@ void SurfaceSet::loadDat(const std::string &filename)
  */
 Surface *SurfaceSet::getFrame(int i)
 {
-	if (_frames.find(i) != _frames.end())
+	std::map<int, Surface*>::const_iterator frame = _frames.find(i);
+	if (frame != _frames.end())
 	{
-		return _frames[i];
+		return frame->second;
 	}
 	return 0;
 }
@@ -241,8 +245,10 @@ Surface *SurfaceSet::getFrame(int i)
  */
 Surface *SurfaceSet::addFrame(int i)
 {
-	_frames[i] = new Surface(_width, _height);
-	return _frames[i];
+	Surface *surface = new Surface(_width, _height);
+	surface->setCacheSpans(true);
+	_frames[i] = surface;
+	return surface;
 }
 
 /**
@@ -17,6 +17,8 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "Timer.h"
+#include <algorithm>
+#include <climits>
 #include "Game.h"
 #include "Options.h"
 
@@ -41,6 +43,7 @@ Uint32 slowTick()
 
 Uint32 Timer::gameSlowSpeed = 1;
 int Timer::maxFrameSkip = 8; // this is a pretty good default at 60FPS.
+int Timer::_timeToDeadline = INT_MAX;
 
 
 /**
@@ -135,6 +138,11 @@ void Timer::think(State* state, Surface* surface)
 			if (_start > _frameSkipStart) _frameSkipStart = _start; // don't play animations in ffwd to catch up :P
 		}
 	}
+	if (_running)
+	{
+		Sint64 due = ((Sint64)_frameSkipStart + _interval - (Sint64)slowTick()) * gameSlowSpeed;
+		_timeToDeadline = (int)std::max((Sint64)0, std::min((Sint64)_timeToDeadline, due));
+	}
 }
 
 /**
@@ -164,4 +172,24 @@ void Timer::onTimer(SurfaceHandler handler)
 	_surface = handler;
 }
 
+/**
+ * Forgets the deadlines collected so far, so the timers
+ * thinking from now on can report theirs.
+ */
+void Timer::resetDeadline()
+{
+	_timeToDeadline = INT_MAX;
+}
+
+/**
+ * Gets how long until the soonest of the running timers that
+ * thought since the last reset has to fire again. The game
+ * can sleep this long without any of them falling behind.
+ * @return Time in milliseconds, or INT_MAX if there's no timer.
+ */
+int Timer::getTimeToDeadline()
+{
+	return _timeToDeadline;
+}
+
 }
@@ -39,6 +39,7 @@ public:
 	static Uint32 gameSlowSpeed;
 
 private:
+	static int _timeToDeadline;
 	Uint32 _start;
 	Uint32 _frameSkipStart;
 	int _interval;
@@ -67,6 +68,10 @@ public:
 	void onTimer(StateHandler handler);
 	/// Hooks a surface action handler to the timer interval.
 	void onTimer(SurfaceHandler handler);
+	/// Forgets the deadlines of the timers that ran so far.
+	static void resetDeadline();
+	/// Gets the time until the next running timer is due.
+	static int getTimeToDeadline();
 };
 
 }
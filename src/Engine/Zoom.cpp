@@ -19,10 +19,14 @@
 
 #include "Zoom.h"
 
+#include <vector>
+#include <algorithm>
+#include <SDL_thread.h>
 #include "Surface.h"
 #include "Logger.h"
 #include "Options.h"
 #include "Screen.h"
+#include "CrossPlatform.h"
 
 #include "OpenGL.h"
 
@@ -61,6 +65,216 @@
 namespace OpenXcom
 {
 
+namespace
+{
+
+/// Work on a band of rows [yFirst, yLast) of an image.
+typedef void (*BandHandler)(void *job, int yFirst, int yLast);
+
+/**
+ * A set of worker threads that split the rows of an image between them,
+ * so the scalers can use every processor. The threads are started the
+ * first time they're needed and stay around, waiting for the next frame.
+ */
+class BandWorkers
+{
+private:
+	std::vector<SDL_Thread*> _threads;
+	SDL_sem *_start, *_done;
+	SDL_mutex *_lock;
+	BandHandler _handler;
+	void *_job;
+	int _rows, _bands, _nextBand;
+	bool _quit;
+
+	/// Runs one band of the current job.
+	void runBand(int band)
+	{
+		int yFirst = _rows * band / _bands;
+		int yLast = _rows * (band + 1) / _bands;
+		if (yFirst < yLast)
+		{
+			_handler(_job, yFirst, yLast);
+		}
+	}
+
+	/// Waits for jobs and runs bands of them until told to quit.
+	static int work(void *data)
+	{
+		BandWorkers *self = (BandWorkers*)data;
+		while (true)
+		{
+			SDL_SemWait(self->_start);
+			if (self->_quit)
+			{
+				break;
+			}
+			SDL_mutexP(self->_lock);
+			int band = self->_nextBand++;
+			SDL_mutexV(self->_lock);
+			self->runBand(band);
+			SDL_SemPost(self->_done);
+		}
+		return 0;
+	}
+public:
+	/// Starts a worker for each processor but the first.
+	BandWorkers() : _start(SDL_CreateSemaphore(0)), _done(SDL_CreateSemaphore(0)), _lock(SDL_CreateMutex()), _handler(0), _job(0), _rows(0), _bands(1), _nextBand(0), _quit(false)
+	{
+		int workers = std::min(CrossPlatform::getProcessorCount(), 8) - 1;
+		for (int i = 0; i < workers && _start && _done && _lock; ++i)
+		{
+			SDL_Thread *thread = SDL_CreateThread(work, this);
+			if (thread == 0)
+			{
+				break;
+			}
+			_threads.push_back(thread);
+		}
+		if (!_threads.empty())
+		{
+			Log(LOG_INFO) << "Scaling the screen with " << _threads.size() + 1 << " threads.";
+		}
+	}
+
+	/// Stops the workers.
+	~BandWorkers()
+	{
+		_quit = true;
+		for (size_t i = 0; i < _threads.size(); ++i)
+		{
+			SDL_SemPost(_start);
+		}
+		for (std::vector<SDL_Thread*>::iterator i = _threads.begin(); i != _threads.end(); ++i)
+		{
+			SDL_WaitThread(*i, 0);
+		}
+		if (_start) SDL_DestroySemaphore(_start);
+		if (_done) SDL_DestroySemaphore(_done);
+		if (_lock) SDL_DestroyMutex(_lock);
+	}
+
+	/**
+	 * Splits the rows of an image into bands and runs them on all the
+	 * workers and the calling thread, returning once they're all done.
+	 * @param handler Function that processes a band of rows.
+	 * @param job Data for the function.
+	 * @param rows Number of rows of the image.
+	 * @param minRows Smallest band worth giving a thread.
+	 */
+	void run(BandHandler handler, void *job, int rows, int minRows)
+	{
+		int bands = std::max(1, std::min((int)_threads.size() + 1, rows / std::max(1, minRows)));
+		if (bands == 1)
+		{
+			handler(job, 0, rows);
+			return;
+		}
+		_handler = handler;
+		_job = job;
+		_rows = rows;
+		_bands = bands;
+		_nextBand = 1;
+		for (int i = 1; i < bands; ++i)
+		{
+			SDL_SemPost(_start);
+		}
+		runBand(0);
+		for (int i = 1; i < bands; ++i)
+		{
+			SDL_SemWait(_done);
+		}
+	}
+
+	/// Gets the shared workers.
+	static BandWorkers &get()
+	{
+		static BandWorkers workers;
+		return workers;
+	}
+};
+
+/// The part of the window inside the black bands, as a surface of its own.
+SDL_Surface *_windowArea = 0;
+/// Scratch surface to scale into when the window can't be written directly.
+SDL_Surface *_staging = 0;
+
+/**
+ * Gets a surface of a certain size and format, reusing the
+ * one from the last frame unless something changed.
+ * @param surface Surface to reuse, updated if replaced.
+ * @param format Surface with the wanted format.
+ * @param width Wanted width.
+ * @param height Wanted height.
+ * @param pixels Pixel memory to use, or 0 to allocate it.
+ * @param pitch Pitch of the pixel memory.
+ * @return The surface.
+ */
+SDL_Surface *reuseSurface(SDL_Surface *&surface, SDL_Surface *format, int width, int height, void *pixels, int pitch)
+{
+	if (surface && (surface->w != width || surface->h != height || surface->format->BitsPerPixel != format->format->BitsPerPixel || (pixels && surface->pitch != pitch)))
+	{
+		SDL_FreeSurface(surface);
+		surface = 0;
+	}
+	if (!surface)
+	{
+		SDL_PixelFormat *fmt = format->format;
+		if (pixels)
+		{
+			surface = SDL_CreateRGBSurfaceFrom(pixels, width, height, fmt->BitsPerPixel, pitch, fmt->Rmask, fmt->Gmask, fmt->Bmask, fmt->Amask);
+		}
+		else
+		{
+			surface = SDL_CreateRGBSurface(format->flags, width, height, fmt->BitsPerPixel, fmt->Rmask, fmt->Gmask, fmt->Bmask, fmt->Amask);
+		}
+	}
+	return surface;
+}
+
+/// An xBRZ scaling job.
+struct XbrzJob
+{
+	size_t factor;
+	SDL_Surface *src, *dst;
+};
+
+/// Scales a band of source rows with xBRZ.
+void xbrzBand(void *job, int yFirst, int yLast)
+{
+	XbrzJob *xbrzJob = (XbrzJob*)job;
+	xbrz::scale(xbrzJob->factor, (uint32_t*)xbrzJob->src->pixels, (uint32_t*)xbrzJob->dst->pixels, xbrzJob->src->w, xbrzJob->src->h, xbrz::RGB, xbrz::ScalerCfg(), yFirst, yLast);
+}
+
+/// A nearest neighbour zooming job.
+struct ZoomJob
+{
+	Uint8 *src;
+	SDL_Surface *dst;
+	const Uint32 *sax;
+	const Sint32 *say;
+};
+
+/// Zooms a band of destination rows, 8-bit without smoothing.
+void zoomBand(void *job, int yFirst, int yLast)
+{
+	ZoomJob *zoomJob = (ZoomJob*)job;
+	for (int y = yFirst; y < yLast; ++y)
+	{
+		const Uint32 *csax = zoomJob->sax;
+		Uint8 *sp = zoomJob->src + zoomJob->say[y];
+		Uint8 *dp = (Uint8*)zoomJob->dst->pixels + y * zoomJob->dst->pitch;
+		for (int x = 0; x < zoomJob->dst->w; ++x)
+		{
+			*dp = *sp;
+			sp += (Sint32)*csax;
+			csax++;
+			dp++;
+		}
+	}
+}
+
+}
 
 /**
  * Optimized 8-bit zoomer for resizing by a factor of 2. Doesn't flip.
@@ -674,7 +888,8 @@ void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, in
 #ifndef __NO_OPENGL
 		if (glOut->buffer_surface)
 		{
-			SDL_BlitSurface(src, 0, glOut->buffer_surface->getSurface(), 0); // TODO; this is less than ideal...
+			// this blit is the palette expansion into the texture buffer, the only copy the frame needs.
+			SDL_BlitSurface(src, 0, glOut->buffer_surface->getSurface(), 0);
 
 			glOut->refresh(glOut->linear, glOut->iwidth, glOut->iheight, dst->w, dst->h, topBlackBand, bottomBlackBand, leftBlackBand, rightBlackBand);
 			SDL_GL_SwapBuffers();
@@ -690,17 +905,32 @@ void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, in
 		SDL_Rect dstrect = {(Sint16)leftBlackBand, (Sint16)topBlackBand, (Uint16)src->w, (Uint16)src->h};
 		SDL_BlitSurface(src, NULL, dst, &dstrect);
 	}
+	else if (src->format->BytesPerPixel == dst->format->BytesPerPixel)
+	{
+		// scale straight into the window, between the black bands.
+		if (SDL_MUSTLOCK(dst)) SDL_LockSurface(dst);
+		Uint8 *pixels = (Uint8*)dst->pixels + topBlackBand * dst->pitch + leftBlackBand * dst->format->BytesPerPixel;
+		SDL_Surface *area = reuseSurface(_windowArea, dst, dstWidth, dstHeight, pixels, dst->pitch);
+		if (area)
+		{
+			area->pixels = pixels;
+			_zoomSurfaceY(src, area, 0, 0);
+		}
+		if (SDL_MUSTLOCK(dst)) SDL_UnlockSurface(dst);
+	}
 	else
 	{
-		SDL_Surface *tmp = SDL_CreateRGBSurface(dst->flags, dstWidth, dstHeight, dst->format->BitsPerPixel, 0, 0, 0, 0);
-		_zoomSurfaceY(src, tmp, 0, 0);
-		if (src->format->palette != NULL)
+		SDL_Surface *tmp = reuseSurface(_staging, dst, dstWidth, dstHeight, 0, 0);
+		if (tmp)
 		{
-			SDL_SetPalette(tmp, SDL_LOGPAL|SDL_PHYSPAL, src->format->palette->colors, 0, src->format->palette->ncolors);
+			_zoomSurfaceY(src, tmp, 0, 0);
+			if (src->format->palette != NULL)
+			{
+				SDL_SetPalette(tmp, SDL_LOGPAL|SDL_PHYSPAL, src->format->palette->colors, 0, src->format->palette->ncolors);
+			}
+			SDL_Rect dstrect = {(Sint16)leftBlackBand, (Sint16)topBlackBand, (Uint16)tmp->w, (Uint16)tmp->h};
+			SDL_BlitSurface(tmp, NULL, dst, &dstrect);
 		}
-		SDL_Rect dstrect = {(Sint16)leftBlackBand, (Sint16)topBlackBand, (Uint16)tmp->w, (Uint16)tmp->h};
-		SDL_BlitSurface(tmp, NULL, dst, &dstrect);
-		SDL_FreeSurface(tmp);
 	}
 }
 
@@ -722,11 +952,12 @@ void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, in
 int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy)
 {
 	int x, y;
-	static Uint32 *sax, *say;
-	Uint32 *csax, *csay;
-	int csx, csy;
-	Uint8 *sp, *dp, *csp;
-	int dgap;
+	static Uint32 *sax;
+	static Sint32 *say;
+	Uint32 *csax;
+	Sint32 *csay;
+	int csx, csy, rowOffset;
+	Uint8 *csp;
 	static bool proclaimed = false;
 
 	if (Screen::use32bitScaler())
@@ -738,7 +969,9 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 			{
 				if (dst->w == src->w * (int)factor && dst->h == src->h * (int)factor)
 				{
-					xbrz::scale(factor, (uint32_t*)src->pixels, (uint32_t*)dst->pixels, src->w, src->h, xbrz::RGB);
+					// xBRZ looks 2 rows past each band, so keep them at least 16 rows tall.
+					XbrzJob job = { factor, src, dst };
+					BandWorkers::get().run(xbrzBand, &job, src->h, 16);
 					return 0;
 				}
 			}
@@ -850,7 +1083,7 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 		sax = 0;
 		return (-1);
 	}
-	if ((say = (Uint32 *) realloc(say, (dst->h + 1) * sizeof(Uint32))) == NULL) {
+	if ((say = (Sint32 *) realloc(say, (dst->h + 1) * sizeof(Sint32))) == NULL) {
 		say = 0;
 		//free(sax);
 		return (-1);
@@ -859,15 +1092,13 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 	/*
 	* Pointer setup
 	*/
-	sp = csp = (Uint8 *) src->pixels;
-	dp = (Uint8 *) dst->pixels;
-	dgap = dst->pitch - dst->w;
+	csp = (Uint8 *) src->pixels;
 
 	if (flipx) csp += (src->w-1);
 	if (flipy) csp  = ( (Uint8*)csp + src->pitch*(src->h-1) );
 
 	/*
-	* Precalculate row increments
+	* Precalculate column increments and row offsets
 	*/
 	csx = 0;
 	csax = sax;
@@ -883,49 +1114,21 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 	}
 	csy = 0;
 	csay = say;
+	rowOffset = 0;
 	for (y = 0; y < dst->h; y++) {
+		*csay = rowOffset;
 		csy += src->h;
-		*csay = 0;
 		while (csy >= dst->h) {
 			csy -= dst->h;
-			(*csay)++;
+			rowOffset += src->pitch * (flipy ? -1 : 1);
 		}
-		(*csay) *= src->pitch * (flipy ? -1 : 1);
 		csay++;
 	}
 	/*
-	* Draw
+	* Draw, a band of rows per thread
 	*/
-	csay = say;
-	for (y = 0; y < dst->h; y++) {
-		csax = sax;
-		sp = csp;
-		for (x = 0; x < dst->w; x++) {
-			/*
-			* Draw
-			*/
-			*dp = *sp;
-			/*
-			* Advance source pointers
-			*/
-			sp += (*csax);
-			csax++;
-			/*
-			* Advance destination pointer
-			*/
-			dp++;
-		}
-		/*
-		* Advance source pointer (for row)
-		*/
-		csp += (*csay);
-		csay++;
-
-		/*
-		* Advance destination pointers
-		*/
-		dp += dgap;
-	}
+	ZoomJob job = { csp, dst, sax, say };
+	BandWorkers::get().run(zoomBand, &job, dst->h, 32);
 
 	/*
 	* Never remove temp arrays
@@ -106,7 +106,7 @@ void ConfirmDestinationState::btnOkClick(Action *)
 		_game->getSavedGame()->getWaypoints()->push_back(w);
 	}
 	_craft->setDestination(_target);
-	_craft->setStatus("STR_OUT");
+	_craft->setStatus(Craft::STATUS_OUT);
 	_game->popState();
 	_game->popState();
 }
@@ -660,10 +660,17 @@ void GeoscapeState::timeAdvance()
 	}
 
 
+	// While nothing is moving or counting down, the 5-second steps can be
+	// skipped up to the next bigger trigger, which may start something again
+	bool idle = isAirspaceIdle();
 	for (int i = 0; i < timeSpan && !_pause; ++i)
 	{
 		TimeTrigger trigger;
 		trigger = _game->getSavedGame()->getTime()->advance();
+		if (trigger == TIME_5SEC && idle)
+		{
+			continue;
+		}
 		switch (trigger)
 		{
 		case TIME_1MONTH:
@@ -679,6 +686,10 @@ void GeoscapeState::timeAdvance()
 		case TIME_5SEC:
 			time5Seconds();
 		}
+		if (trigger != TIME_5SEC)
+		{
+			idle = isAirspaceIdle();
+		}
 	}
 
 	_pause = !_dogfightsToBeStarted.empty() || _zoomInEffectTimer->isRunning() || _zoomOutEffectTimer->isRunning();
@@ -1034,6 +1045,39 @@ void GeoscapeState::time5Seconds()
 	}
 }
 
+/**
+ * Checks if nothing on the Geoscape is moving or counting down: every UFO
+ * has crashed and been detected, no craft is headed anywhere, taking off
+ * or destroyed, and there are no dogfights or waypoints. Craft hovering
+ * out of base without a destination still count as idle.
+ * time5Seconds() leaves such a Geoscape exactly as it is and rolls
+ * no random numbers, so it can be skipped without changing the game.
+ * @return True if the 5-second steps can be skipped.
+ */
+bool GeoscapeState::isAirspaceIdle() const
+{
+	SavedGame *save = _game->getSavedGame();
+	if (save->getBases()->empty() || save->getEnding() == END_LOSE)
+		return false;
+	if (!_dogfights.empty() || !_dogfightsToBeStarted.empty() || !save->getWaypoints()->empty())
+		return false;
+	for (std::vector<Ufo*>::const_iterator i = save->getUfos()->begin(); i != save->getUfos()->end(); ++i)
+	{
+		// Crashed UFOs only count down every 30 minutes
+		if ((*i)->getStatus() != Ufo::CRASHED || !(*i)->getDetected() || (*i)->getSecondsRemaining() == 0)
+			return false;
+	}
+	for (std::vector<Base*>::const_iterator i = save->getBases()->begin(); i != save->getBases()->end(); ++i)
+	{
+		for (std::vector<Craft*>::const_iterator j = (*i)->getCrafts()->begin(); j != (*i)->getCrafts()->end(); ++j)
+		{
+			if ((*j)->isDestroyed() || (*j)->getDestination() != 0 || (*j)->getTakeoff() != 0)
+				return false;
+		}
+	}
+	return true;
+}
+
 /**
  * Functor that attempt to detect an XCOM base.
  */
@@ -1088,7 +1132,7 @@ void GeoscapeState::time10Minutes()
 		// Fuel consumption for XCOM craft.
 		for (std::vector<Craft*>::iterator j = (*i)->getCrafts()->begin(); j != (*i)->getCrafts()->end(); ++j)
 		{
-			if ((*j)->getStatus() == "STR_OUT")
+			if ((*j)->getStatus() == Craft::STATUS_OUT)
 			{
 				(*j)->consumeFuel();
 				if (!(*j)->getLowFuel() && (*j)->getFuel() <= (*j)->getFuelLimit())
@@ -1263,7 +1307,7 @@ void GeoscapeState::time30Minutes()
 	{
 		for (std::vector<Craft*>::iterator j = (*i)->getCrafts()->begin(); j != (*i)->getCrafts()->end(); ++j)
 		{
-			if ((*j)->getStatus() == "STR_REFUELLING")
+			if ((*j)->getStatus() == Craft::STATUS_REFUELLING)
 			{
 				std::string s = (*j)->refuel();
 				if (!s.empty())
@@ -1320,7 +1364,7 @@ void GeoscapeState::time30Minutes()
 					}
 					for (std::vector<Craft*>::iterator c = (*b)->getCrafts()->begin(); !detected && c != (*b)->getCrafts()->end(); ++c)
 					{
-						if ((*c)->getStatus() == "STR_OUT" && (*c)->detect(*u))
+						if ((*c)->getStatus() == Craft::STATUS_OUT && (*c)->detect(*u))
 						{
 							detected = true;
 							break;
@@ -1351,7 +1395,7 @@ void GeoscapeState::time30Minutes()
 					}
 					for (std::vector<Craft*>::iterator c = (*b)->getCrafts()->begin(); !detected && c != (*b)->getCrafts()->end(); ++c)
 					{
-						if ((*c)->getStatus() == "STR_OUT" && (*c)->insideRadarRange(*u))
+						if ((*c)->getStatus() == Craft::STATUS_OUT && (*c)->insideRadarRange(*u))
 						{
 							detected = true;
 							hyperdetected = (*u)->getHyperDetected();
@@ -1401,11 +1445,11 @@ void GeoscapeState::time1Hour()
 	{
 		for (std::vector<Craft*>::iterator j = (*i)->getCrafts()->begin(); j != (*i)->getCrafts()->end(); ++j)
 		{
-			if ((*j)->getStatus() == "STR_REPAIRS")
+			if ((*j)->getStatus() == Craft::STATUS_REPAIRS)
 			{
 				(*j)->repair();
 			}
-			else if ((*j)->getStatus() == "STR_REARMING")
+			else if ((*j)->getStatus() == Craft::STATUS_REARMING)
 			{
 				std::string s = (*j)->rearm(_game->getMod());
 				if (!s.empty())
@@ -150,6 +150,8 @@ public:
 	/// Update the resolution settings, we just resized the window.
 	void resize(int &dX, int &dY);
 private:
+	/// Checks if the 5-second steps would leave the Geoscape as it is.
+	bool isAirspaceIdle() const;
 	/// Handle alien mission generation.
 	void determineAlienMissions();
 	/// Process each individual mission script command.
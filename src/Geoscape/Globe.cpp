@@ -314,11 +314,6 @@ Globe::~Globe()
 	delete _markerSet;
 	delete _radars;
 	delete _clipper;
-
-	for (std::list<Polygon*>::iterator i = _cacheLand.begin(); i != _cacheLand.end(); ++i)
-	{
-		delete *i;
-	}
 }
 
 /**
@@ -395,46 +390,7 @@ bool Globe::pointBack(double lon, double lat) const
 
 Polygon* Globe::getPolygonFromLonLat(double lon, double lat) const
 {
-	const double zDiscard=0.75f;
-	double coslat = cos(lat);
-	double sinlat = sin(lat);
-
-	for (std::list<Polygon*>::iterator i = _rules->getPolygons()->begin(); i != _rules->getPolygons()->end(); ++i)
-	{
-		double x, y, z, x2, y2;
-		double clat, clon;
-		z = 0;
-		for (int j = 0; j < (*i)->getPoints(); ++j)
-		{
-			z = coslat * cos((*i)->getLatitude(j)) * cos((*i)->getLongitude(j) - lon) + sinlat * sin((*i)->getLatitude(j));
-			if (z<zDiscard) break; //discarded
-		}
-		if (z<zDiscard) continue; //discarded
-
-		bool odd = false;
-
-		clat = (*i)->getLatitude(0); //initial point
-		clon = (*i)->getLongitude(0);
-		x = cos(clat) * sin(clon - lon);
-		y = coslat * sin(clat) - sinlat * cos(clat) * cos(clon - lon);
-
-		for (int j = 0; j < (*i)->getPoints(); ++j)
-		{
-			int k = (j + 1) % (*i)->getPoints(); //index of next point in poly
-			clat = (*i)->getLatitude(k);
-			clon = (*i)->getLongitude(k);
-
-			x2 = cos(clat) * sin(clon - lon);
-			y2 = coslat * sin(clat) - sinlat * cos(clat) * cos(clon - lon);
-			if ( ((y>0)!=(y2>0)) && (0 < (x2-x)*(0-y)/(y2-y)+x) )
-				odd = !odd;
-			x = x2;
-			y = y2;
-
-		}
-		if (odd) return *i;
-	}
-	return NULL;
+	return _rules->getPolygonAt(lon, lat);
 }
 
 /**
@@ -764,54 +720,58 @@ std::vector<Target*> Globe::getTargets(int x, int y, bool craft) const
  */
 void Globe::cachePolygons()
 {
-	cache(_rules->getPolygons(), &_cacheLand);
-}
-
-/**
- * Caches a set of polygons.
- * @param polygons Pointer to list of polygons.
- * @param cache Pointer to cache.
- */
-void Globe::cache(std::list<Polygon*> *polygons, std::list<Polygon*> *cache)
-{
-	// Clear existing cache
-	for (std::list<Polygon*>::iterator i = cache->begin(); i != cache->end(); ++i)
-	{
-		delete *i;
-	}
-	cache->clear();
-
-	// Pre-calculate values to cache
-	for (std::list<Polygon*>::iterator i = polygons->begin(); i != polygons->end(); ++i)
+	std::list<Polygon*> *polygons = _rules->getPolygons();
+	const std::vector<double> &pointX = _rules->getPointX();
+	const std::vector<double> &pointY = _rules->getPointY();
+	const std::vector<double> &pointZ = _rules->getPointZ();
+	const std::vector<size_t> &polygonFirst = _rules->getPolygonFirst();
+
+	// Rotate every point to the view in one go:
+	// x goes right, y goes down and z points at the viewer
+	const double sinLon = sin(_cenLon), cosLon = cos(_cenLon);
+	const double sinLat = sin(_cenLat), cosLat = cos(_cenLat);
+	const size_t points = pointX.size();
+	_viewX.resize(points);
+	_viewY.resize(points);
+	_viewZ.resize(points);
+	for (size_t i = 0; i < points; ++i)
+	{
+		const double front = pointX[i] * cosLon + pointY[i] * sinLon;
+		_viewX[i] = pointY[i] * cosLon - pointX[i] * sinLon;
+		_viewY[i] = cosLat * pointZ[i] - sinLat * front;
+		_viewZ[i] = cosLat * front + sinLat * pointZ[i];
+	}
+
+	_cacheLand.clear();
+	_cacheFirst.clear();
+	_cacheX.clear();
+	_cacheY.clear();
+	size_t polygon = 0;
+	for (std::list<Polygon*>::iterator i = polygons->begin(); i != polygons->end(); ++i, ++polygon)
 	{
 		// Is quad on the back face?
 		double closest = 0.0;
-		double z;
 		double furthest = 0.0;
-		for (int j = 0; j < (*i)->getPoints(); ++j)
+		for (size_t j = polygonFirst[polygon]; j < polygonFirst[polygon + 1]; ++j)
 		{
-			z = cos(_cenLat) * cos((*i)->getLatitude(j)) * cos((*i)->getLongitude(j) - _cenLon) + sin(_cenLat) * sin((*i)->getLatitude(j));
-			if (z > closest)
-				closest = z;
-			else if (z < furthest)
-				furthest = z;
+			if (_viewZ[j] > closest)
+				closest = _viewZ[j];
+			else if (_viewZ[j] < furthest)
+				furthest = _viewZ[j];
 		}
 		if (-furthest > closest)
 			continue;
 
-		Polygon* p = new Polygon(**i);
-
 		// Convert coordinates
-		for (int j = 0; j < p->getPoints(); ++j)
+		_cacheLand.push_back(*i);
+		_cacheFirst.push_back(_cacheX.size());
+		for (size_t j = polygonFirst[polygon]; j < polygonFirst[polygon + 1]; ++j)
 		{
-			Sint16 x, y;
-			polarToCart(p->getLongitude(j), p->getLatitude(j), &x, &y);
-			p->setX(j, x);
-			p->setY(j, y);
+			_cacheX.push_back(_cenX + (Sint16)floor(_radius * _viewX[j]));
+			_cacheY.push_back(_cenY + (Sint16)floor(_radius * _viewY[j]));
 		}
-
-		cache->push_back(p);
 	}
+	_cacheFirst.push_back(_cacheX.size());
 }
 
 /**
@@ -911,19 +871,11 @@ void Globe::drawOcean()
  */
 void Globe::drawLand()
 {
-	Sint16 x[4], y[4];
-
-	for (std::list<Polygon*>::iterator i = _cacheLand.begin(); i != _cacheLand.end(); ++i)
+	for (size_t i = 0; i < _cacheLand.size(); ++i)
 	{
-		// Convert coordinates
-		for (int j = 0; j < (*i)->getPoints(); ++j)
-		{
-			x[j] = (*i)->getX(j);
-			y[j] = (*i)->getY(j);
-		}
-
 		// Apply textures according to zoom and shade
-		drawTexturedPolygon(x, y, (*i)->getPoints(), _texture->getFrame((*i)->getTexture() + _zoomTexture), 0, 0);
+		size_t first = _cacheFirst[i];
+		drawTexturedPolygon(&_cacheX[first], &_cacheY[first], (int)(_cacheFirst[i + 1] - first), _texture->getFrame(_cacheLand[i]->getTexture() + _zoomTexture), 0, 0);
 	}
 }
 
@@ -1145,7 +1097,7 @@ void Globe::drawRadars()
 
 		for (std::vector<Craft*>::iterator j = (*i)->getCrafts()->begin(); j != (*i)->getCrafts()->end(); ++j)
 		{
-			if ((*j)->getStatus() != "STR_OUT")
+			if ((*j)->getStatus() != Craft::STATUS_OUT)
 				continue;
 			lat=(*j)->getLatitude();
 			lon=(*j)->getLongitude();
@@ -1487,7 +1439,7 @@ void Globe::drawFlights()
 		for (std::vector<Craft*>::iterator j = (*i)->getCrafts()->begin(); j != (*i)->getCrafts()->end(); ++j)
 		{
 			// Hide crafts docked at base
-			if ((*j)->getStatus() != "STR_OUT" || (*j)->getDestination() == 0 /*|| pointBack((*j)->getLongitude(), (*j)->getLatitude())*/)
+			if ((*j)->getStatus() != Craft::STATUS_OUT || (*j)->getDestination() == 0 /*|| pointBack((*j)->getLongitude(), (*j)->getLatitude())*/)
 				continue;
 
 			double lon1 = (*j)->getLongitude();
@@ -62,7 +62,12 @@ private:
 	bool _hover, _craft;
 	int _blink;
 	Timer *_blinkTimer, *_rotTimer;
-	std::list<Polygon*> _cacheLand;
+	/// World polygon points rotated to the current view.
+	std::vector<double> _viewX, _viewY, _viewZ;
+	/// Visible polygons, and the index of each one's first point in the screen coordinates.
+	std::vector<Polygon*> _cacheLand;
+	std::vector<size_t> _cacheFirst;
+	std::vector<Sint16> _cacheX, _cacheY;
 	FastLineClip *_clipper;
 	double _radius, _radiusStep;
 	///normal of each pixel in earth globe per zoom level
@@ -87,8 +92,6 @@ private:
 	Polygon* getPolygonFromLonLat(double lon, double lat) const;
 	/// Checks if a target is near a point.
 	bool targetNear(Target* target, int x, int y) const;
-	/// Caches a set of polygons.
-	void cache(std::list<Polygon*> *polygons, std::list<Polygon*> *cache);
 	/// Get position of sun relative to given position in polar cords and date.
 	Cord getSunDirection(double lon, double lat) const;
 	/// Draw globe range circle.
@@ -138,7 +138,7 @@ SelectDestinationState::SelectDestinationState(Craft *craft, Globe *globe) : _cr
 		_btnCydonia->onMouseClick((ActionHandler)&SelectDestinationState::btnCydoniaClick);
 	}
 
-	if (_craft->getStatus() != "STR_OUT")
+	if (_craft->getStatus() != Craft::STATUS_OUT)
 	{
 		_globe->setCraftRange(_craft->getLongitude(), _craft->getLatitude(), _craft->getBaseRange());
 		_globe->invalidate();
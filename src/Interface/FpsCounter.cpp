@@ -19,9 +19,11 @@
 
 #include "FpsCounter.h"
 #include <cmath>
+#include <algorithm>
 #include "../Engine/Action.h"
 #include "../Engine/Timer.h"
 #include "../Engine/Options.h"
+#include "../Engine/Logger.h"
 #include "NumberText.h"
 
 namespace OpenXcom
@@ -36,6 +38,7 @@ namespace OpenXcom
  */
 FpsCounter::FpsCounter(int width, int height, int x, int y) : Surface(width, height, x, y), _frames(0)
 {
+	_frameTimePercentiles[0] = _frameTimePercentiles[1] = _frameTimePercentiles[2] = 0;
 	_visible = Options::fpsCounter;
 
 	_timer = new Timer(1000);
@@ -97,7 +100,8 @@ void FpsCounter::think()
 }
 
 /**
- * Updates the amount of Frames per Second.
+ * Updates the amount of Frames per Second,
+ * and the frame time percentiles.
  */
 void FpsCounter::update()
 {
@@ -105,6 +109,21 @@ void FpsCounter::update()
 	_text->setValue(fps);
 	_frames = 0;
 	_redraw = true;
+
+	if (!_frameTimes.empty())
+	{
+		// 50th, 95th and 99th percentile
+		std::sort(_frameTimes.begin(), _frameTimes.end());
+		size_t last = _frameTimes.size() - 1;
+		_frameTimePercentiles[0] = _frameTimes[last * 50 / 100];
+		_frameTimePercentiles[1] = _frameTimes[last * 95 / 100];
+		_frameTimePercentiles[2] = _frameTimes[last * 99 / 100];
+		_frameTimes.clear();
+		if (_visible)
+		{
+			Log(LOG_VERBOSE) << "FPS: " << fps << ", frame times: " << _frameTimePercentiles[0] << "us (50%) " << _frameTimePercentiles[1] << "us (95%) " << _frameTimePercentiles[2] << "us (99%)";
+		}
+	}
 }
 
 /**
@@ -116,9 +135,31 @@ void FpsCounter::draw()
 	_text->blit(this);
 }
 
-void FpsCounter::addFrame()
+/**
+ * Counts a frame.
+ * @param frameTime Time since the previous frame, in microseconds.
+ */
+void FpsCounter::addFrame(Uint32 frameTime)
 {
 	_frames++;
+	if (frameTime != 0)
+	{
+		_frameTimes.push_back(frameTime);
+	}
+}
+
+/**
+ * Gets how long frames took over the last second.
+ * @param percentile Which percentile: 50, 95 or 99.
+ * @return Frame time in microseconds.
+ */
+Uint32 FpsCounter::getFrameTime(int percentile) const
+{
+	if (percentile >= 99)
+		return _frameTimePercentiles[2];
+	if (percentile >= 95)
+		return _frameTimePercentiles[1];
+	return _frameTimePercentiles[0];
 }
 
 }
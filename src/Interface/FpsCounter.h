@@ -17,6 +17,7 @@
  * You should have received a copy of the GNU General Public License
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <vector>
 #include "../Engine/Surface.h"
 
 namespace OpenXcom
@@ -29,6 +30,7 @@ class Action;
 /**
  * Counts the amount of frames each second
  * and displays them in a NumberText surface.
+ * Also keeps track of how long the frames took.
  */
 class FpsCounter : public Surface
 {
@@ -36,6 +38,8 @@ private:
 	NumberText *_text;
 	Timer *_timer;
 	int _frames;
+	std::vector<Uint32> _frameTimes;
+	Uint32 _frameTimePercentiles[3];
 public:
 	/// Creates a new FPS counter linked to a game.
 	FpsCounter(int width, int height, int x, int y);
@@ -53,7 +57,10 @@ public:
 	void update();
 	/// Draws the FPS counter.
 	void draw();
-	void addFrame();
+	/// Adds a frame and the time it took.
+	void addFrame(Uint32 frameTime = 0);
+	/// Gets a percentile of the frame times over the last second.
+	Uint32 getFrameTime(int percentile) const;
 };
 
 }
@@ -18,6 +18,7 @@
  */
 #include "RuleGlobe.h"
 #include <SDL_endian.h>
+#include <algorithm>
 #include <fstream>
 #include "../Engine/Exception.h"
 #include "Polygon.h"
@@ -31,6 +32,69 @@
 namespace OpenXcom
 {
 
+namespace
+{
+
+/// Size of a polygon lookup cell, in radians.
+const double CELL_SIZE = M_PI / 45;
+const int LON_CELLS = 90;
+const int LAT_CELLS = 45;
+/// Slack added around polygon bounds against rounding.
+const double CELL_EPSILON = 1e-6;
+
+/**
+ * Gets the lookup grid column of a longitude,
+ * wrapping around the globe.
+ * @param lon Longitude in radians.
+ * @return Column index.
+ */
+int getLonCell(double lon)
+{
+	int cell = (int)floor(lon / CELL_SIZE) % LON_CELLS;
+	return cell < 0 ? cell + LON_CELLS : cell;
+}
+
+/**
+ * Gets the lookup grid row of a latitude.
+ * @param lat Latitude in radians.
+ * @return Row index.
+ */
+int getLatCell(double lat)
+{
+	return Clamp((int)floor((lat + M_PI / 2) / CELL_SIZE), 0, LAT_CELLS - 1);
+}
+
+/**
+ * Gets the highest Z reached along the shorter
+ * great circle arc between two unit vectors.
+ * @return Highest Z of the arc.
+ */
+double getArcTop(double ax, double ay, double az, double bx, double by, double bz)
+{
+	double top = std::max(az, bz);
+	double nx = ay * bz - az * by;
+	double ny = az * bx - ax * bz;
+	double nz = ax * by - ay * bx;
+	double n2 = nx * nx + ny * ny + nz * nz;
+	if (n2 > 0.0)
+	{
+		// The circle gets closest to the pole where the pole projects on its plane,
+		// which only counts if that lies between the two ends
+		double vx = -nz * nx / n2;
+		double vy = -nz * ny / n2;
+		double vz = 1.0 - nz * nz / n2;
+		double afterA = (ay * vz - az * vy) * nx + (az * vx - ax * vz) * ny + (ax * vy - ay * vx) * nz;
+		double beforeB = (vy * bz - vz * by) * nx + (vz * bx - vx * bz) * ny + (vx * by - vy * bx) * nz;
+		if (afterA >= 0.0 && beforeB >= 0.0)
+		{
+			top = std::max(top, sqrt(vz));
+		}
+	}
+	return top;
+}
+
+}
+
 /**
  * Creates a blank ruleset for globe contents.
  */
@@ -71,6 +135,7 @@ void RuleGlobe::load(const YAML::Node &node)
 		}
 		_polygons.clear();
 		loadDat(FileMap::getFilePath(node["data"].as<std::string>()));
+		indexPolygons();
 	}
 	if (node["polygons"])
 	{
@@ -85,6 +150,7 @@ void RuleGlobe::load(const YAML::Node &node)
 			polygon->load(*i);
 			_polygons.push_back(polygon);
 		}
+		indexPolygons();
 	}
 	if (node["polylines"])
 	{
@@ -149,6 +215,160 @@ std::list<Polygon*> *RuleGlobe::getPolygons()
 	return &_polygons;
 }
 
+/**
+ * Stores the points of the world polygons as unit vectors, and files
+ * each polygon under every lat/lon cell it could contain a point of,
+ * so point lookups only need to test a handful of nearby polygons.
+ */
+void RuleGlobe::indexPolygons()
+{
+	_polygonTable.assign(_polygons.begin(), _polygons.end());
+	_pointX.clear();
+	_pointY.clear();
+	_pointZ.clear();
+	_polygonFirst.clear();
+	for (std::vector<Polygon*>::iterator i = _polygonTable.begin(); i != _polygonTable.end(); ++i)
+	{
+		_polygonFirst.push_back(_pointX.size());
+		for (int j = 0; j < (*i)->getPoints(); ++j)
+		{
+			double lon = (*i)->getLongitude(j);
+			double lat = (*i)->getLatitude(j);
+			_pointX.push_back(cos(lat) * cos(lon));
+			_pointY.push_back(cos(lat) * sin(lon));
+			_pointZ.push_back(sin(lat));
+		}
+	}
+	_polygonFirst.push_back(_pointX.size());
+
+	// A point can only test inside a polygon if it lies within the spherical hull
+	// of the polygon's corners, so file each polygon under the cells of that hull
+	std::vector< std::vector<size_t> > cells(LON_CELLS * LAT_CELLS);
+	for (size_t polygon = 0; polygon < _polygonTable.size(); ++polygon)
+	{
+		const size_t first = _polygonFirst[polygon], last = _polygonFirst[polygon + 1];
+
+		// The hull's latitudes are bounded by the arcs between its corners
+		double top = -1.0, bottom = 1.0;
+		for (size_t j = first; j < last; ++j)
+		{
+			for (size_t k = j; k < last; ++k)
+			{
+				top = std::max(top, getArcTop(_pointX[j], _pointY[j], _pointZ[j], _pointX[k], _pointY[k], _pointZ[k]));
+				bottom = std::min(bottom, -getArcTop(_pointX[j], _pointY[j], -_pointZ[j], _pointX[k], _pointY[k], -_pointZ[k]));
+			}
+		}
+
+		// and its longitudes by the shortest span covering every corner,
+		// unless the corners surround a pole, which the hull may then reach
+		bool pole = false;
+		std::vector<double> lons;
+		for (size_t j = first; j < last; ++j)
+		{
+			if (_pointX[j] * _pointX[j] + _pointY[j] * _pointY[j] < CELL_EPSILON * CELL_EPSILON)
+				pole = true;
+			else
+				lons.push_back(atan2(_pointY[j], _pointX[j]));
+		}
+		int lonBegin = 0, lonCells = LON_CELLS;
+		if (!pole && !lons.empty())
+		{
+			std::sort(lons.begin(), lons.end());
+			double start = lons.front();
+			double gap = lons.front() + 2 * M_PI - lons.back();
+			for (size_t j = 1; j < lons.size(); ++j)
+			{
+				if (lons[j] - lons[j - 1] > gap)
+				{
+					gap = lons[j] - lons[j - 1];
+					start = lons[j];
+				}
+			}
+			double span = 2 * M_PI - gap;
+			if (span < M_PI)
+			{
+				lonBegin = getLonCell(start - CELL_EPSILON);
+				lonCells = (getLonCell(start + span + CELL_EPSILON) - lonBegin + LON_CELLS) % LON_CELLS + 1;
+			}
+		}
+		if (lonCells == LON_CELLS)
+		{
+			if (top > 0.0)
+				top = 1.0;
+			if (bottom < 0.0)
+				bottom = -1.0;
+		}
+
+		int latBegin = getLatCell(asin(Clamp(bottom, -1.0, 1.0)) - CELL_EPSILON);
+		int latEnd = getLatCell(asin(Clamp(top, -1.0, 1.0)) + CELL_EPSILON);
+		for (int y = latBegin; y <= latEnd; ++y)
+		{
+			for (int x = 0; x < lonCells; ++x)
+			{
+				cells[y * LON_CELLS + (lonBegin + x) % LON_CELLS].push_back(polygon);
+			}
+		}
+	}
+
+	_cellFirst.clear();
+	_cellPolygons.clear();
+	for (std::vector< std::vector<size_t> >::iterator i = cells.begin(); i != cells.end(); ++i)
+	{
+		_cellFirst.push_back(_cellPolygons.size());
+		_cellPolygons.insert(_cellPolygons.end(), i->begin(), i->end());
+	}
+	_cellFirst.push_back(_cellPolygons.size());
+}
+
+/**
+ * Returns the first world polygon containing a point,
+ * only testing the polygons filed under its cell.
+ * @param lon Longitude of the point.
+ * @param lat Latitude of the point.
+ * @return Pointer to the polygon, or 0 if the point is in the ocean.
+ */
+Polygon *RuleGlobe::getPolygonAt(double lon, double lat) const
+{
+	if (_cellFirst.empty())
+		return 0;
+
+	const double zDiscard = 0.75;
+	const double cosLon = cos(lon), sinLon = sin(lon);
+	const double cosLat = cos(lat), sinLat = sin(lat);
+	const size_t cell = getLatCell(lat) * LON_CELLS + getLonCell(lon);
+	for (size_t i = _cellFirst[cell]; i < _cellFirst[cell + 1]; ++i)
+	{
+		const size_t polygon = _cellPolygons[i];
+		const size_t first = _polygonFirst[polygon], last = _polygonFirst[polygon + 1];
+
+		bool discard = (first == last);
+		for (size_t j = first; j < last && !discard; ++j)
+		{
+			double z = cosLat * (_pointX[j] * cosLon + _pointY[j] * sinLon) + sinLat * _pointZ[j];
+			discard = z < zDiscard;
+		}
+		if (discard)
+			continue;
+
+		// Project the corners on the plane touching the point and count the edges crossing a ray from it
+		bool odd = false;
+		double x = _pointY[last - 1] * cosLon - _pointX[last - 1] * sinLon;
+		double y = cosLat * _pointZ[last - 1] - sinLat * (_pointX[last - 1] * cosLon + _pointY[last - 1] * sinLon);
+		for (size_t j = first; j < last; ++j)
+		{
+			double x2 = _pointY[j] * cosLon - _pointX[j] * sinLon;
+			double y2 = cosLat * _pointZ[j] - sinLat * (_pointX[j] * cosLon + _pointY[j] * sinLon);
+			if (((y > 0) != (y2 > 0)) && (0 < (x2 - x) * (0 - y) / (y2 - y) + x))
+				odd = !odd;
+			x = x2;
+			y = y2;
+		}
+		if (odd)
+			return _polygonTable[polygon];
+	}
+	return 0;
+}
+
 /**
  * Returns the list of polylines in the globe.
  * @return Pointer to the list of polylines.
@@ -19,6 +19,7 @@
  */
 #include <list>
 #include <string>
+#include <vector>
 #include <yaml-cpp/yaml.h>
 
 namespace OpenXcom
@@ -39,6 +40,14 @@ private:
 	std::list<Polygon*> _polygons;
 	std::list<Polyline*> _polylines;
 	std::map<int, Texture*> _textures;
+	/// World polygons in load order, and the unit vectors of their points.
+	std::vector<Polygon*> _polygonTable;
+	std::vector<double> _pointX, _pointY, _pointZ;
+	std::vector<size_t> _polygonFirst;
+	/// Polygons that can contain a point of each lat/lon cell, in load order.
+	std::vector<size_t> _cellFirst, _cellPolygons;
+	/// Rebuilds the polygon vectors and lookup grid.
+	void indexPolygons();
 public:
 	/// Creates a blank globe ruleset.
 	RuleGlobe();
@@ -48,6 +57,14 @@ public:
 	void load(const YAML::Node& node);
 	/// Gets the list of world polygons.
 	std::list<Polygon*> *getPolygons();
+	/// Gets the world polygon containing a point.
+	Polygon *getPolygonAt(double lon, double lat) const;
+	/// Gets the unit vectors of the world polygons' points.
+	const std::vector<double> &getPointX() const { return _pointX; }
+	const std::vector<double> &getPointY() const { return _pointY; }
+	const std::vector<double> &getPointZ() const { return _pointZ; }
+	/// Gets the index of each world polygon's first point, plus one past the last.
+	const std::vector<size_t> &getPolygonFirst() const { return _polygonFirst; }
 	/// Gets the list of world polylines.
 	std::list<Polyline*> *getPolylines();
 	/// Loads a set of polygons from a DAT file.
@@ -520,7 +520,7 @@ int Base::getAvailableSoldiers(bool checkCombatReadiness) const
 		{
 			total++;
 		}
-		else if (checkCombatReadiness && (((*i)->getCraft() != 0 && (*i)->getCraft()->getStatus() != "STR_OUT") ||
+		else if (checkCombatReadiness && (((*i)->getCraft() != 0 && (*i)->getCraft()->getStatus() != Craft::STATUS_OUT) ||
 			((*i)->getCraft() == 0 && (*i)->getWoundRecovery() == 0)))
 		{
 			total++;
@@ -717,7 +717,7 @@ double Base::getIgnoredStores()
 	double space = 0;
 	for (std::vector<Craft*>::iterator c = getCrafts()->begin(); c != getCrafts()->end(); ++c)
 	{
-		if ((*c)->getStatus() == "STR_REARMING")
+		if ((*c)->getStatus() == Craft::STATUS_REARMING)
 		{
 			for (std::vector<CraftWeapon*>::iterator w = (*c)->getWeapons()->begin(); w != (*c)->getWeapons()->end() ; ++w)
 			{
@@ -1409,7 +1409,7 @@ void Base::setupDefenses()
 	// add vehicles that are in the crafts of the base, if it's not out
 	for (std::vector<Craft*>::iterator c = getCrafts()->begin(); c != getCrafts()->end(); ++c)
 	{
-		if ((*c)->getStatus() != "STR_OUT")
+		if ((*c)->getStatus() != Craft::STATUS_OUT)
 		{
 			for (std::vector<Vehicle*>::iterator i = (*c)->getVehicles()->begin(); i != (*c)->getVehicles()->end(); ++i)
 			{
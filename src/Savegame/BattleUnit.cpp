@@ -33,6 +33,7 @@
 #include "../Mod/RuleSoldier.h"
 #include "../Mod/Mod.h"
 #include "Tile.h"
+#include "UnitGrid.h"
 #include "SavedGame.h"
 #include "SavedBattleGame.h"
 #include "BattleUnitStatistics.h"
@@ -47,7 +48,7 @@ namespace OpenXcom
  * @param depth the depth of the battlefield (used to determine movement type in case of MT_FLOAT).
  */
 BattleUnit::BattleUnit(Soldier *soldier, int depth) :
-	_faction(FACTION_PLAYER), _originalFaction(FACTION_PLAYER), _killedBy(FACTION_PLAYER), _id(0), _tile(0),
+	_faction(FACTION_PLAYER), _originalFaction(FACTION_PLAYER), _killedBy(FACTION_PLAYER), _id(0), _tile(0), _unitGrid(0),
 	_lastPos(Position()), _direction(0), _toDirection(0), _directionTurret(0), _toDirectionTurret(0),
 	_verticalDirection(0), _status(STATUS_STANDING), _walkPhase(0), _fallPhase(0), _kneeled(false), _floating(false),
 	_dontReselect(false), _fire(0), _currentAIState(0), _visible(false), _cacheInvalid(true),
@@ -164,7 +165,7 @@ BattleUnit::BattleUnit(Soldier *soldier, int depth) :
  */
 BattleUnit::BattleUnit(Unit *unit, UnitFaction faction, int id, Armor *armor, StatAdjustment *adjustment, int depth) :
 	_faction(faction), _originalFaction(faction), _killedBy(faction), _id(id),
-	_tile(0), _lastPos(Position()), _direction(0), _toDirection(0), _directionTurret(0),
+	_tile(0), _unitGrid(0), _lastPos(Position()), _direction(0), _toDirection(0), _directionTurret(0),
 	_toDirectionTurret(0),  _verticalDirection(0), _status(STATUS_STANDING), _walkPhase(0),
 	_fallPhase(0), _kneeled(false), _floating(false), _dontReselect(false), _fire(0), _currentAIState(0),
 	_visible(false), _cacheInvalid(true), _expBravery(0), _expReactions(0), _expFiring(0),
@@ -491,7 +492,9 @@ int BattleUnit::getId() const
 void BattleUnit::setPosition(Position pos, bool updateLastPos)
 {
 	if (updateLastPos) { _lastPos = _pos; }
+	Position from = _pos;
 	_pos = pos;
+	if (_unitGrid) _unitGrid->moveUnit(this, from);
 }
 
 /**
@@ -676,7 +679,7 @@ void BattleUnit::keepWalking(Tile *tileBelowMe, bool cache)
 	}
 	if (!cache)
 	{
-		_pos = _destination;
+		setPosition(_destination, false);
 		end = 2;
 	}
 
@@ -687,7 +690,7 @@ void BattleUnit::keepWalking(Tile *tileBelowMe, bool cache)
 	{
 		// we assume we reached our destination tile
 		// this is actually a drawing hack, so soldiers are not overlapped by floortiles
-		_pos = _destination;
+		setPosition(_destination, false);
 	}
 
 	if (_walkPhase >= end)
@@ -1893,6 +1896,16 @@ Tile *BattleUnit::getTile() const
 	return _tile;
 }
 
+/**
+ * Sets the grid that indexes this unit by position,
+ * so the unit can report its moves to it.
+ * @param grid Pointer to the unit grid.
+ */
+void BattleUnit::setUnitGrid(UnitGrid *grid)
+{
+	_unitGrid = grid;
+}
+
 /**
  * Checks if there's an inventory item in
  * the specified inventory position.
@@ -44,6 +44,7 @@ class Armor;
 class SavedGame;
 class Language;
 class AIModule;
+class UnitGrid;
 struct BattleUnitStatistics;
 struct StatAdjustment;
 
@@ -66,6 +67,7 @@ private:
 	int _id;
 	Position _pos;
 	Tile *_tile;
+	UnitGrid *_unitGrid;
 	Position _lastPos;
 	int _direction, _toDirection;
 	int _directionTurret, _toDirectionTurret;
@@ -298,6 +300,8 @@ public:
 	void setTile(Tile *tile, Tile *tileBelow = 0);
 	/// Gets the unit's tile.
 	Tile *getTile() const;
+	/// Sets the grid that indexes this unit by position.
+	void setUnitGrid(UnitGrid *grid);
 	/// Gets the item in the specified slot.
 	BattleItem *getItem(RuleInventory *slot, int x = 0, int y = 0) const;
 	/// Gets the item in the specified slot.
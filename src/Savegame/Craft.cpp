@@ -40,6 +40,14 @@
 namespace OpenXcom
 {
 
+const char *Craft::STATUS_STRING[] = {
+	"STR_READY",
+	"STR_OUT",
+	"STR_REPAIRS",
+	"STR_REFUELLING",
+	"STR_REARMING"
+};
+
 /**
  * Initializes a craft of the specified type and
  * assigns it the latest craft ID available.
@@ -47,7 +55,7 @@ namespace OpenXcom
  * @param base Pointer to base of origin.
  * @param id ID to assign to the craft (0 to not assign).
  */
-Craft::Craft(RuleCraft *rules, Base *base, int id) : MovingTarget(), _rules(rules), _base(base), _fuel(0), _damage(0), _interceptionOrder(0), _takeoff(0), _status("STR_READY"), _lowFuel(false), _mission(false), _inBattlescape(false), _inDogfight(false)
+Craft::Craft(RuleCraft *rules, Base *base, int id) : MovingTarget(), _rules(rules), _base(base), _fuel(0), _damage(0), _interceptionOrder(0), _takeoff(0), _status(STATUS_READY), _lowFuel(false), _mission(false), _inBattlescape(false), _inDogfight(false)
 {
 	_items = new ItemContainer();
 	if (id != 0)
@@ -145,7 +153,15 @@ void Craft::load(const YAML::Node &node, const Mod *mod, SavedGame *save)
 			Log(LOG_ERROR) << "Failed to load item " << type;
 		}
 	}
-	_status = node["status"].as<std::string>(_status);
+	std::string status = node["status"].as<std::string>(STATUS_STRING[_status]);
+	for (int i = STATUS_READY; i <= STATUS_REARMING; ++i)
+	{
+		if (STATUS_STRING[i] == status)
+		{
+			_status = (CraftStatus)i;
+			break;
+		}
+	}
 	_lowFuel = node["lowFuel"].as<bool>(_lowFuel);
 	_mission = node["mission"].as<bool>(_mission);
 	_interceptionOrder = node["interceptionOrder"].as<int>(_interceptionOrder);
@@ -237,7 +253,7 @@ YAML::Node Craft::save() const
 	{
 		node["vehicles"].push_back((*i)->save());
 	}
-	node["status"] = _status;
+	node["status"] = STATUS_STRING[_status];
 	if (_lowFuel)
 		node["lowFuel"] = _lowFuel;
 	if (_mission)
@@ -311,7 +327,7 @@ std::string Craft::getDefaultName(Language *lang) const
  */
 int Craft::getMarker() const
 {
-	if (_status != "STR_OUT")
+	if (_status != STATUS_OUT)
 		return -1;
 	else if (_rules->getMarker() == -1)
 		return 1;
@@ -344,18 +360,28 @@ void Craft::setBase(Base *base, bool move)
 
 /**
  * Returns the current status of the craft.
- * @return Status string.
+ * @return Status.
  */
-std::string Craft::getStatus() const
+Craft::CraftStatus Craft::getStatus() const
 {
 	return _status;
 }
 
+/**
+ * Returns the current status of the craft
+ * as a translatable string.
+ * @return Status string.
+ */
+std::string Craft::getStatusString() const
+{
+	return STATUS_STRING[_status];
+}
+
 /**
  * Changes the current status of the craft.
- * @param status Status string.
+ * @param status Status.
  */
-void Craft::setStatus(const std::string &status)
+void Craft::setStatus(CraftStatus status)
 {
 	_status = status;
 }
@@ -384,7 +410,7 @@ std::string Craft::getAltitude() const
  */
 void Craft::setDestination(Target *dest)
 {
-	if (_status != "STR_OUT")
+	if (_status != STATUS_OUT)
 	{
 		_takeoff = 60;
 	}
@@ -723,15 +749,15 @@ void Craft::checkup()
 
 	if (_damage > 0)
 	{
-		_status = "STR_REPAIRS";
+		_status = STATUS_REPAIRS;
 	}
 	else if (available != full)
 	{
-		_status = "STR_REARMING";
+		_status = STATUS_REARMING;
 	}
 	else
 	{
-		_status = "STR_REFUELLING";
+		_status = STATUS_REFUELLING;
 	}
 }
 
@@ -785,7 +811,7 @@ void Craft::repair()
 	setDamage(_damage - _rules->getRepairRate());
 	if (_damage <= 0)
 	{
-		_status = "STR_REARMING";
+		_status = STATUS_REARMING;
 	}
 }
 
@@ -817,7 +843,7 @@ std::string Craft::refuel()
 				fuel = item;
 				if (_fuel > 0)
 				{
-					_status = "STR_READY";
+					_status = STATUS_READY;
 				}
 				else
 				{
@@ -828,12 +854,12 @@ std::string Craft::refuel()
 	}
 	if (_fuel >= _rules->getMaxFuel())
 	{
-		_status = "STR_READY";
+		_status = STATUS_READY;
 		for (std::vector<CraftWeapon*>::iterator i = _weapons.begin(); i != _weapons.end(); ++i)
 		{
 			if (*i && (*i)->isRearming())
 			{
-				_status = "STR_REARMING";
+				_status = STATUS_REARMING;
 				break;
 			}
 		}
@@ -854,7 +880,7 @@ std::string Craft::rearm(const Mod *mod)
 	{
 		if (i == _weapons.end())
 		{
-			_status = "STR_REFUELLING";
+			_status = STATUS_REFUELLING;
 			break;
 		}
 		if (*i != 0 && (*i)->isRearming())
@@ -1000,6 +1026,15 @@ int Craft::getInterceptionOrder() const
 	return _interceptionOrder;
 }
 
+/**
+ * Gets the time left before the craft takes off.
+ * @return Time in 5-second steps.
+ */
+int Craft::getTakeoff() const
+{
+	return _takeoff;
+}
+
 /**
  * Gets the craft's unique id.
  * @return A tuple of the craft's type and per-type id.
@@ -1063,7 +1098,7 @@ void Craft::unload(const Mod *mod)
  */
 void Craft::reuseItem(const std::string& item)
 {
-	if (_status != "STR_READY")
+	if (_status != STATUS_READY)
 		return;
 	// Check if it's ammo to reload the craft
 	for (std::vector<CraftWeapon*>::iterator w = _weapons.begin(); w != _weapons.end(); ++w)
@@ -1071,12 +1106,12 @@ void Craft::reuseItem(const std::string& item)
 		if ((*w) != 0 && item == (*w)->getRules()->getClipItem() && (*w)->getAmmo() < (*w)->getRules()->getAmmoMax())
 		{
 			(*w)->setRearming(true);
-			_status = "STR_REARMING";
+			_status = STATUS_REARMING;
 		}
 	}
 	// Check if it's fuel to refuel the craft
 	if (item == _rules->getRefuelItem() && _fuel < _rules->getMaxFuel())
-		_status = "STR_REFUELLING";
+		_status = STATUS_REFUELLING;
 }
 
 }
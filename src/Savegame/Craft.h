@@ -44,6 +44,9 @@ class Vehicle;
  */
 class Craft : public MovingTarget
 {
+public:
+	static const char *STATUS_STRING[];
+	enum CraftStatus { STATUS_READY, STATUS_OUT, STATUS_REPAIRS, STATUS_REFUELLING, STATUS_REARMING };
 private:
 	RuleCraft *_rules;
 	Base *_base;
@@ -51,7 +54,7 @@ private:
 	std::vector<CraftWeapon*> _weapons;
 	ItemContainer *_items;
 	std::vector<Vehicle*> _vehicles;
-	std::string _status;
+	CraftStatus _status;
 	bool _lowFuel, _mission, _inBattlescape, _inDogfight;
 	double _speedMaxRadian;
 
@@ -82,9 +85,11 @@ public:
 	/// Sets the craft's base.
 	void setBase(Base *base, bool move = true);
 	/// Gets the craft's status.
-	std::string getStatus() const;
+	CraftStatus getStatus() const;
+	/// Gets the craft's status string.
+	std::string getStatusString() const;
 	/// Sets the craft's status.
-	void setStatus(const std::string &status);
+	void setStatus(CraftStatus status);
 	/// Gets the craft's altitude.
 	std::string getAltitude() const;
 	/// Sets the craft's destination.
@@ -173,6 +178,8 @@ public:
 	void setInterceptionOrder(const int order);
 	/// Gets interception number.
 	int getInterceptionOrder() const;
+	/// Gets the time left before the craft takes off.
+	int getTakeoff() const;
 	/// Gets the craft's unique id.
 	CraftId getUniqueId() const;
 	/// Unloads the craft.
@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "MovingTarget.h"
+#include <algorithm>
 #include "../fmath.h"
 #include "SerializationHelper.h"
 #include "../Engine/Options.h"
@@ -152,7 +153,8 @@ void MovingTarget::setSpeed(int speed)
 {
 	_speed = speed;
 	_speedRadian = calculateRadianSpeed(_speed);
-	// Recalculate meeting point for any followers
+	// Recalculate meeting point for this and any followers
+	_meetCalculated = false;
 	for (std::vector<MovingTarget *>::iterator i = getFollowers()->begin(); i != getFollowers()->end(); ++i)
 	{
 		(*i)->resetMeetPoint();
@@ -262,39 +264,79 @@ void MovingTarget::calculateMeetPoint()
 	// Speed ratio
 	if (AreSame(t->getSpeedRadian(), 0.0)) return;
 	const double speedRatio = _speedRadian/ t->getSpeedRadian();
-
-	// The direction pseudovector
-	double	nx = cos(t->getLatitude())*sin(t->getLongitude())*sin(t->getDestination()->getLatitude()) -
-					sin(t->getLatitude())*cos(t->getDestination()->getLatitude())*sin(t->getDestination()->getLongitude()),
-			ny = sin(t->getLatitude())*cos(t->getDestination()->getLatitude())*cos(t->getDestination()->getLongitude()) -
-					cos(t->getLatitude())*cos(t->getLongitude())*sin(t->getDestination()->getLatitude()),
-			nz = cos(t->getLatitude())*cos(t->getDestination()->getLatitude())*sin(t->getDestination()->getLongitude() - t->getLongitude());
-	// Normalize and multiplex with radian speed
-	double	nk = _speedRadian/sqrt(nx*nx+ny*ny+nz*nz);
-	nx *= nk;
-	ny *= nk;
-	nz *= nk;
-
-	// Finding the meeting point. Don't search further than halfway across the
-	// globe (distance from interceptor's current point >= 1), as that may
-	// cause the interceptor to go the wrong way later.
-	for (double path = 0, distance = 1;
-		path < M_PI && distance - path*speedRatio > 0 && path*speedRatio < 1;
-		path += _speedRadian)
+	// The target's position and the normal of the great circle it follows
+	const double tx = cos(t->getLatitude()) * cos(t->getLongitude()),
+			ty = cos(t->getLatitude()) * sin(t->getLongitude()),
+			tz = sin(t->getLatitude());
+	const double dx = cos(t->getDestination()->getLatitude()) * cos(t->getDestination()->getLongitude()),
+			dy = cos(t->getDestination()->getLatitude()) * sin(t->getDestination()->getLongitude()),
+			dz = sin(t->getDestination()->getLatitude());
+	double nx = ty * dz - tz * dy,
+			ny = tz * dx - tx * dz,
+			nz = tx * dy - ty * dx;
+	const double nk = sqrt(nx * nx + ny * ny + nz * nz);
+	if (nk < 1e-12)
 	{
-		_meetPointLat += nx*sin(_meetPointLon) - ny*cos(_meetPointLon);
-		if (std::abs(_meetPointLat) < M_PI_2) _meetPointLon += nz - (nx*cos(_meetPointLon) + ny*sin(_meetPointLon))*tan(_meetPointLat); else _meetPointLon += M_PI;
-
-		distance = acos(cos(_lat) * cos(_meetPointLat) * cos(_meetPointLon - _lon) + sin(_lat) * sin(_meetPointLat));
+		_meetCalculated = true;
+		return;
 	}
-
-	// Correction overflowing angles
-	double lonSign = Sign(_meetPointLon);
-	double latSign = Sign(_meetPointLat);
-	while (std::abs(_meetPointLon) > M_PI) _meetPointLon -= lonSign * 2 * M_PI;
-	while (std::abs(_meetPointLat) > M_PI) _meetPointLat -= latSign * 2 * M_PI;
-	if (std::abs(_meetPointLat) > M_PI_2) { _meetPointLat = latSign * std::abs(2 * M_PI - std::abs(_meetPointLat)); _meetPointLon -= lonSign * M_PI; }
-
+	nx /= nk;
+	ny /= nk;
+	nz /= nk;
+	// After covering an angle s the target is at T cos(s) + M sin(s),
+	// so the interceptor's distance to it is acos(a cos(s) + b sin(s))
+	const double mx = ny * tz - nz * ty,
+			my = nz * tx - nx * tz,
+			mz = nx * ty - ny * tx;
+	const double cx = cos(_lat) * cos(_lon), cy = cos(_lat) * sin(_lon), cz = sin(_lat);
+	const double a = cx * tx + cy * ty + cz * tz;
+	const double b = cx * mx + cy * my + cz * mz;
+	// Finding the first s where that distance is no more than the interceptor
+	// covers meanwhile. Don't search further than halfway across the globe
+	// (distance from interceptor's current point >= 1), as that may cause the
+	// interceptor to go the wrong way later.
+	const double sMax = std::min(M_PI, 1.0 / speedRatio);
+	double s = 0.0, lo = 0.0, hi = sMax;
+	for (int i = 0; i < 256; ++i)
+	{
+		const double c = Clamp(a * cos(s) + b * sin(s), -1.0, 1.0);
+		const double gap = acos(c) - s * speedRatio;
+		if (gap > 0.0)
+			lo = s;
+		else
+			hi = s;
+		if (std::abs(gap) < 1e-9 || hi - lo < 1e-9)
+			break;
+		double next;
+		if (speedRatio > 1.0)
+		{
+			// The gap only ever shrinks, so Newton's method is safe within its bracket
+			const double slope = (a * sin(s) - b * cos(s)) / sqrt(std::max(1.0 - c * c, 1e-12)) - speedRatio;
+			next = s - gap / slope;
+			if (!(next > lo && next < hi))
+				next = (lo + hi) / 2;
+		}
+		else
+		{
+			// The gap can close by at most 1 + speedRatio per unit of s,
+			// so stepping by that never passes its first zero; a gap the
+			// interceptor covers in one move is close enough
+			if (gap <= _speedRadian)
+				break;
+			next = s + gap / (1.0 + speedRatio);
+			if (next >= sMax)
+			{
+				s = sMax;
+				break;
+			}
+		}
+		s = next;
+	}
+	const double px = tx * cos(s) + mx * sin(s),
+			py = ty * cos(s) + my * sin(s),
+			pz = tz * cos(s) + mz * sin(s);
+	_meetPointLat = asin(Clamp(pz, -1.0, 1.0));
+	_meetPointLon = atan2(py, px);
 	_meetCalculated = true;
 }
 
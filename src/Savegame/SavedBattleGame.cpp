@@ -487,6 +487,16 @@ Tile **SavedBattleGame::getTiles() const
 	return _tiles;
 }
 
+/**
+ * Gets the frequently used values of all tiles (light, smoke, fire, fog of war, units...),
+ * stored in contiguous arrays indexed by getTileIndex() for fast map-wide sweeps.
+ * @return A pointer to the tile store.
+ */
+TileStore *SavedBattleGame::getTileStore()
+{
+	return &_tileStore;
+}
+
 /**
  * Initializes the array of tiles and creates a pathfinding object.
  * @param mapsize_x
@@ -521,11 +531,12 @@ void SavedBattleGame::initMap(int mapsize_x, int mapsize_y, int mapsize_z, bool
 	_mapsize_y = mapsize_y;
 	_mapsize_z = mapsize_z;
 	_tiles = new Tile*[_mapsize_z * _mapsize_y * _mapsize_x];
+	_tileStore.resize(_mapsize_z * _mapsize_y * _mapsize_x);
 	for (int i = 0; i < _mapsize_z * _mapsize_y * _mapsize_x; ++i)
 	{
 		Position pos;
 		getTileCoords(i, &pos.x, &pos.y, &pos.z);
-		_tiles[i] = new Tile(pos);
+		_tiles[i] = new Tile(pos, &_tileStore, i);
 	}
 
 }
@@ -776,6 +787,21 @@ std::vector<BattleUnit*> *SavedBattleGame::getUnits()
 	return &_units;
 }
 
+/**
+ * Gets the live units standing within a square radius of a position,
+ * in the order they appear in the list of units.
+ * Callers are expected to apply their own exact range check.
+ * @param pos Center position.
+ * @param radius Radius in tiles.
+ * @param units Vector to fill with the units found.
+ * @param ignoreFaction Faction to leave out, or -1 for none.
+ */
+void SavedBattleGame::getUnitsInRange(Position pos, int radius, std::vector<BattleUnit*> &units, int ignoreFaction)
+{
+	_unitGrid.update(_units, _mapsize_x, _mapsize_y);
+	_unitGrid.getUnits(pos, radius, units, ignoreFaction);
+}
+
 /**
  * Gets the list of items.
  * @return Pointer to the list of items.
@@ -1162,7 +1188,7 @@ BattleUnit *SavedBattleGame::convertUnit(BattleUnit *unit, const SavedGame* save
 		getItems()->push_back(bi);
 	}
 	newUnit->setVisible(visible);
-	getTileEngine()->calculateFOV(newUnit->getPosition());
+	getTileEngine()->calculateFOV(newUnit->getPosition(), 1, false);
 	getTileEngine()->applyGravity(newUnit->getTile());
 	newUnit->dontReselect();
 	return newUnit;
@@ -1362,6 +1388,8 @@ Node *SavedBattleGame::getPatrolNode(bool scout, BattleUnit *unit, Node *fromNod
 
 /**
  * Carries out new turn preparations such as fire and smoke spreading.
+ * Only the tiles on the tile store's active list can be burning or smoking,
+ * so those are all that get looked at, in the same map order as a full scan.
  */
 void SavedBattleGame::prepareNewTurn()
 {
@@ -1369,11 +1397,12 @@ void SavedBattleGame::prepareNewTurn()
 	std::vector<Tile*> tilesOnSmoke;
 
 	// prepare a list of tiles on fire
-	for (int i = 0; i < _mapsize_x * _mapsize_y * _mapsize_z; ++i)
+	_tileStore.sortActive();
+	for (std::vector<int>::const_iterator i = _tileStore.active.begin(); i != _tileStore.active.end(); ++i)
 	{
-		if (getTiles()[i]->getFire() > 0)
+		if (_tiles[*i]->getFire() > 0)
 		{
-			tilesOnFire.push_back(getTiles()[i]);
+			tilesOnFire.push_back(_tiles[*i]);
 		}
 	}
 
@@ -1432,20 +1461,27 @@ void SavedBattleGame::prepareNewTurn()
 						}
 					}
 				}
+				getPathfinding()->invalidateTerrain((*i)->getPosition());
 				getTileEngine()->applyGravity(*i);
 			}
 		}
 	}
 
 	// prepare a list of tiles on fire/with smoke in them (smoke acts as fire intensity)
-	for (int i = 0; i < _mapsize_x * _mapsize_y * _mapsize_z; ++i)
+	_tileStore.sortActive();
+	for (std::vector<int>::const_iterator i = _tileStore.active.begin(); i != _tileStore.active.end(); ++i)
 	{
-		if (getTiles()[i]->getSmoke() > 0)
+		if (_tiles[*i]->getSmoke() > 0)
 		{
-			tilesOnSmoke.push_back(getTiles()[i]);
+			tilesOnSmoke.push_back(_tiles[*i]);
 		}
-		getTiles()[i]->setDangerous(false);
 	}
+	for (std::vector<int>::const_iterator i = _tileStore.dangerous.begin(); i != _tileStore.dangerous.end(); ++i)
+	{
+		_tiles[*i]->setDangerous(false);
+		_tileStore.listed[*i] &= ~TileStore::LISTED_DANGEROUS;
+	}
+	_tileStore.dangerous.clear();
 
 	// now make the smoke spread.
 	for (std::vector<Tile*>::iterator i = tilesOnSmoke.begin(); i != tilesOnSmoke.end(); ++i)
@@ -1502,10 +1538,13 @@ void SavedBattleGame::prepareNewTurn()
 	if (!tilesOnFire.empty() || !tilesOnSmoke.empty())
 	{
 		// do damage to units, average out the smoke, etc.
-		for (int i = 0; i < _mapsize_x * _mapsize_y * _mapsize_z; ++i)
+		// by index, in case hurting a unit puts more tiles on the list.
+		_tileStore.sortActive();
+		for (size_t i = 0; i < _tileStore.active.size(); ++i)
 		{
-			if (getTiles()[i]->getSmoke() != 0)
-				getTiles()[i]->prepareNewTurn(getDepth() == 0);
+			Tile *tile = _tiles[_tileStore.active[i]];
+			if (tile->getSmoke() != 0)
+				tile->prepareNewTurn(getDepth() == 0);
 		}
 		// fires could have been started, stopped or smoke could reveal/conceal units.
 		getTileEngine()->calculateTerrainLighting();
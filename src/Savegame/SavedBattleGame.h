@@ -21,6 +21,8 @@
 #include <string>
 #include <yaml-cpp/yaml.h>
 #include "BattleUnit.h"
+#include "TileStore.h"
+#include "UnitGrid.h"
 #include "../Mod/AlienDeployment.h"
 
 namespace OpenXcom
@@ -51,9 +53,11 @@ private:
 	int _mapsize_x, _mapsize_y, _mapsize_z;
 	std::vector<MapDataSet*> _mapDataSets;
 	Tile **_tiles;
+	TileStore _tileStore;
 	BattleUnit *_selectedUnit, *_lastSelectedUnit;
 	std::vector<Node*> _nodes;
 	std::vector<BattleUnit*> _units;
+	UnitGrid _unitGrid;
 	std::vector<BattleItem*> _items, _deleted;
 	Pathfinding *_pathfinding;
 	TileEngine *_tileEngine;
@@ -106,12 +110,16 @@ public:
 	int getGlobalShade() const;
 	/// Gets a pointer to the tiles, a tile is the smallest component of battlescape.
 	Tile **getTiles() const;
+	/// Gets the frequently used values of all tiles, in contiguous arrays.
+	TileStore *getTileStore();
 	/// Gets a pointer to the list of nodes.
 	std::vector<Node*> *getNodes();
 	/// Gets a pointer to the list of items.
 	std::vector<BattleItem*> *getItems();
 	/// Gets a pointer to the list of units.
 	std::vector<BattleUnit*> *getUnits();
+	/// Gets the live units within a radius of a position.
+	void getUnitsInRange(Position pos, int radius, std::vector<BattleUnit*> &units, int ignoreFaction = -1);
 	/// Gets terrain size x.
 	int getMapSizeX() const;
 	/// Gets terrain size y.
@@ -48,25 +48,16 @@ Tile::SerializationKey Tile::serializationKey =
 /**
  * constructor
  * @param pos Position.
+ * @param store Store holding the frequently used values of the map's tiles, already reset.
+ * @param index Index of this tile in the store.
  */
-Tile::Tile(Position pos): _smoke(0), _fire(0), _explosive(0), _explosiveType(0), _pos(pos), _unit(0), _animationOffset(0), _markerColor(0), _visible(false), _preview(-1), _TUMarker(-1), _overlaps(0), _danger(false), _obstacle(0)
+Tile::Tile(Position pos, TileStore *store, int index): _store(store), _index(index), _explosive(0), _explosiveType(0), _pos(pos), _animationOffset(0), _markerColor(0), _preview(-1), _TUMarker(-1), _overlaps(0), _danger(false), _obstacle(0)
 {
 	for (int i = 0; i < 4; ++i)
 	{
 		_objects[i] = 0;
-		_mapDataID[i] = -1;
-		_mapDataSetID[i] = -1;
 		_currentFrame[i] = 0;
 	}
-	for (int layer = 0; layer < LIGHTLAYERS; layer++)
-	{
-		_light[layer] = 0;
-		_lastLight[layer] = -1;
-	}
-	for (int i = 0; i < 3; ++i)
-	{
-		_discovered[i] = false;
-	}
 }
 
 /**
@@ -91,17 +82,20 @@ void Tile::load(const YAML::Node &node)
 	//_position = node["position"].as<Position>(_position);
 	for (int i = 0; i < 4; i++)
 	{
-		_mapDataID[i] = node["mapDataID"][i].as<int>(_mapDataID[i]);
-		_mapDataSetID[i] = node["mapDataSetID"][i].as<int>(_mapDataSetID[i]);
+		_store->mapDataID[_index * 4 + i] = node["mapDataID"][i].as<int>(_store->mapDataID[_index * 4 + i]);
+		_store->mapDataSetID[_index * 4 + i] = node["mapDataSetID"][i].as<int>(_store->mapDataSetID[_index * 4 + i]);
 	}
-	_fire = node["fire"].as<int>(_fire);
-	_smoke = node["smoke"].as<int>(_smoke);
+	_store->fire[_index] = node["fire"].as<int>(_store->fire[_index]);
+	_store->smoke[_index] = node["smoke"].as<int>(_store->smoke[_index]);
 	if (node["discovered"])
 	{
+		Uint8 discovered = 0;
 		for (int i = 0; i < 3; i++)
 		{
-			_discovered[i] = node["discovered"][i].as<bool>();
+			if (node["discovered"][i].as<bool>())
+				discovered |= 1 << i;
 		}
+		_store->discovered[_index] = discovered;
 	}
 	if (node["openDoorWest"])
 	{
@@ -111,8 +105,9 @@ void Tile::load(const YAML::Node &node)
 	{
 		_currentFrame[2] = 7;
 	}
-	if (_fire || _smoke)
+	if (_store->fire[_index] || _store->smoke[_index])
 	{
+		_store->activate(_index);
 		_animationOffset = std::rand() % 4;
 	}
 }
@@ -124,26 +119,25 @@ void Tile::load(const YAML::Node &node)
  */
 void Tile::loadBinary(Uint8 *buffer, Tile::SerializationKey& serKey)
 {
-	_mapDataID[0] = unserializeInt(&buffer, serKey._mapDataID);
-	_mapDataID[1] = unserializeInt(&buffer, serKey._mapDataID);
-	_mapDataID[2] = unserializeInt(&buffer, serKey._mapDataID);
-	_mapDataID[3] = unserializeInt(&buffer, serKey._mapDataID);
-	_mapDataSetID[0] = unserializeInt(&buffer, serKey._mapDataSetID);
-	_mapDataSetID[1] = unserializeInt(&buffer, serKey._mapDataSetID);
-	_mapDataSetID[2] = unserializeInt(&buffer, serKey._mapDataSetID);
-	_mapDataSetID[3] = unserializeInt(&buffer, serKey._mapDataSetID);
-
-	_smoke = unserializeInt(&buffer, serKey._smoke);
-	_fire = unserializeInt(&buffer, serKey._fire);
+	_store->mapDataID[_index * 4 + 0] = unserializeInt(&buffer, serKey._mapDataID);
+	_store->mapDataID[_index * 4 + 1] = unserializeInt(&buffer, serKey._mapDataID);
+	_store->mapDataID[_index * 4 + 2] = unserializeInt(&buffer, serKey._mapDataID);
+	_store->mapDataID[_index * 4 + 3] = unserializeInt(&buffer, serKey._mapDataID);
+	_store->mapDataSetID[_index * 4 + 0] = unserializeInt(&buffer, serKey._mapDataSetID);
+	_store->mapDataSetID[_index * 4 + 1] = unserializeInt(&buffer, serKey._mapDataSetID);
+	_store->mapDataSetID[_index * 4 + 2] = unserializeInt(&buffer, serKey._mapDataSetID);
+	_store->mapDataSetID[_index * 4 + 3] = unserializeInt(&buffer, serKey._mapDataSetID);
+
+	_store->smoke[_index] = unserializeInt(&buffer, serKey._smoke);
+	_store->fire[_index] = unserializeInt(&buffer, serKey._fire);
 
 	Uint8 boolFields = unserializeInt(&buffer, serKey.boolFields);
-	_discovered[0] = (boolFields & 1) ? true : false;
-	_discovered[1] = (boolFields & 2) ? true : false;
-	_discovered[2] = (boolFields & 4) ? true : false;
+	_store->discovered[_index] = boolFields & 7;
 	_currentFrame[1] = (boolFields & 8) ? 7 : 0;
 	_currentFrame[2] = (boolFields & 0x10) ? 7 : 0;
-	if (_fire || _smoke)
+	if (_store->fire[_index] || _store->smoke[_index])
 	{
+		_store->activate(_index);
 		_animationOffset = std::rand() % 4;
 	}
 }
@@ -159,18 +153,18 @@ YAML::Node Tile::save() const
 	node["position"] = _pos;
 	for (int i = 0; i < 4; i++)
 	{
-		node["mapDataID"].push_back(_mapDataID[i]);
-		node["mapDataSetID"].push_back(_mapDataSetID[i]);
+		node["mapDataID"].push_back(_store->mapDataID[_index * 4 + i]);
+		node["mapDataSetID"].push_back(_store->mapDataSetID[_index * 4 + i]);
 	}
-	if (_smoke)
-		node["smoke"] = _smoke;
-	if (_fire)
-		node["fire"] = _fire;
-	if (_discovered[O_FLOOR] || _discovered[O_WESTWALL] || _discovered[O_NORTHWALL])
+	if (_store->smoke[_index])
+		node["smoke"] = _store->smoke[_index];
+	if (_store->fire[_index])
+		node["fire"] = _store->fire[_index];
+	if (isDiscovered(O_FLOOR) || isDiscovered(O_WESTWALL) || isDiscovered(O_NORTHWALL))
 	{
 		for (int i = O_FLOOR; i <= O_NORTHWALL; i++)
 		{
-			node["discovered"].push_back(_discovered[i]);
+			node["discovered"].push_back(isDiscovered(i));
 		}
 	}
 	if (isUfoDoorOpen(O_WESTWALL))
@@ -190,19 +184,19 @@ YAML::Node Tile::save() const
  */
 void Tile::saveBinary(Uint8** buffer) const
 {
-	serializeInt(buffer, serializationKey._mapDataID, _mapDataID[0]);
-	serializeInt(buffer, serializationKey._mapDataID, _mapDataID[1]);
-	serializeInt(buffer, serializationKey._mapDataID, _mapDataID[2]);
-	serializeInt(buffer, serializationKey._mapDataID, _mapDataID[3]);
-	serializeInt(buffer, serializationKey._mapDataSetID, _mapDataSetID[0]);
-	serializeInt(buffer, serializationKey._mapDataSetID, _mapDataSetID[1]);
-	serializeInt(buffer, serializationKey._mapDataSetID, _mapDataSetID[2]);
-	serializeInt(buffer, serializationKey._mapDataSetID, _mapDataSetID[3]);
-
-	serializeInt(buffer, serializationKey._smoke, _smoke);
-	serializeInt(buffer, serializationKey._fire, _fire);
-
-	Uint8 boolFields = (_discovered[0]?1:0) + (_discovered[1]?2:0) + (_discovered[2]?4:0);
+	serializeInt(buffer, serializationKey._mapDataID, _store->mapDataID[_index * 4 + 0]);
+	serializeInt(buffer, serializationKey._mapDataID, _store->mapDataID[_index * 4 + 1]);
+	serializeInt(buffer, serializationKey._mapDataID, _store->mapDataID[_index * 4 + 2]);
+	serializeInt(buffer, serializationKey._mapDataID, _store->mapDataID[_index * 4 + 3]);
+	serializeInt(buffer, serializationKey._mapDataSetID, _store->mapDataSetID[_index * 4 + 0]);
+	serializeInt(buffer, serializationKey._mapDataSetID, _store->mapDataSetID[_index * 4 + 1]);
+	serializeInt(buffer, serializationKey._mapDataSetID, _store->mapDataSetID[_index * 4 + 2]);
+	serializeInt(buffer, serializationKey._mapDataSetID, _store->mapDataSetID[_index * 4 + 3]);
+
+	serializeInt(buffer, serializationKey._smoke, _store->smoke[_index]);
+	serializeInt(buffer, serializationKey._fire, _store->fire[_index]);
+
+	Uint8 boolFields = _store->discovered[_index];
 	boolFields |= isUfoDoorOpen(O_WESTWALL) ? 8 : 0; // west
 	boolFields |= isUfoDoorOpen(O_NORTHWALL) ? 0x10 : 0; // north?
 	serializeInt(buffer, serializationKey.boolFields, boolFields);
@@ -218,8 +212,10 @@ void Tile::saveBinary(Uint8** buffer) const
 void Tile::setMapData(MapData *dat, int mapDataID, int mapDataSetID, TilePart part)
 {
 	_objects[part] = dat;
-	_mapDataID[part] = mapDataID;
-	_mapDataSetID[part] = mapDataSetID;
+	_store->mapDataID[_index * 4 + part] = mapDataID;
+	_store->mapDataSetID[_index * 4 + part] = mapDataSetID;
+	_store->voxelState[_index] = TileStore::VOXELS_DIRTY;
+	++_store->changes;
 }
 
 /**
@@ -231,8 +227,8 @@ void Tile::setMapData(MapData *dat, int mapDataID, int mapDataSetID, TilePart pa
  */
 void Tile::getMapData(int *mapDataID, int *mapDataSetID, TilePart part) const
 {
-	*mapDataID = _mapDataID[part];
-	*mapDataSetID = _mapDataSetID[part];
+	*mapDataID = _store->mapDataID[_index * 4 + part];
+	*mapDataSetID = _store->mapDataSetID[_index * 4 + part];
 }
 
 /**
@@ -241,7 +237,7 @@ void Tile::getMapData(int *mapDataID, int *mapDataSetID, TilePart part) const
  */
 bool Tile::isVoid() const
 {
-	return _objects[0] == 0 && _objects[1] == 0 && _objects[2] == 0 && _objects[3] == 0 && _smoke == 0 && _inventory.empty();
+	return _objects[0] == 0 && _objects[1] == 0 && _objects[2] == 0 && _objects[3] == 0 && _store->smoke[_index] == 0 && _inventory.empty();
 }
 
 /**
@@ -345,9 +341,9 @@ int Tile::openDoor(TilePart part, BattleUnit *unit, BattleActionType reserve)
 			return -1;
 		if (unit && unit->getTimeUnits() < _objects[part]->getTUCost(unit->getMovementType()) + unit->getActionTUs(reserve, unit->getMainHandWeapon(false)))
 			return 4;
-		if (_unit && _unit != unit && _unit->getPosition() != getPosition())
+		if (_store->unit[_index] && _store->unit[_index] != unit && _store->unit[_index]->getPosition() != getPosition())
 			return -1;
-		setMapData(_objects[part]->getDataset()->getObject(_objects[part]->getAltMCD()), _objects[part]->getAltMCD(), _mapDataSetID[part],
+		setMapData(_objects[part]->getDataset()->getObject(_objects[part]->getAltMCD()), _objects[part]->getAltMCD(), _store->mapDataSetID[_index * 4 + part],
 				   _objects[part]->getDataset()->getObject(_objects[part]->getAltMCD())->getObjectType());
 		setMapData(0, -1, -1, part);
 		return 0;
@@ -357,6 +353,8 @@ int Tile::openDoor(TilePart part, BattleUnit *unit, BattleActionType reserve)
 		if (unit &&	unit->getTimeUnits() < _objects[part]->getTUCost(unit->getMovementType()) + unit->getActionTUs(reserve, unit->getMainHandWeapon(false)))
 			return 4;
 		_currentFrame[part] = 1; // start opening door
+		_store->voxelState[_index] = TileStore::VOXELS_DIRTY;
+		++_store->changes;
 		return 1;
 	}
 	if (_objects[part]->isUFODoor() && _currentFrame[part] != 7) // ufo door != part 7 - door is still opening
@@ -375,6 +373,8 @@ int Tile::closeUfoDoor()
 		if (isUfoDoorOpen((TilePart)part))
 		{
 			_currentFrame[part] = 0;
+			_store->voxelState[_index] = TileStore::VOXELS_DIRTY;
+			++_store->changes;
 			retval = 1;
 		}
 	}
@@ -389,18 +389,21 @@ int Tile::closeUfoDoor()
  */
 void Tile::setDiscovered(bool flag, int part)
 {
-	if (_discovered[part] != flag)
+	Uint8 &discovered = _store->discovered[_index];
+	if (isDiscovered(part) != flag)
 	{
-		_discovered[part] = flag;
+		if (flag)
+			discovered |= 1 << part;
+		else
+			discovered &= ~(1 << part);
 		if (part == 2 && flag == true)
 		{
-			_discovered[0] = true;
-			_discovered[1] = true;
+			discovered |= 3;
 		}
 		// if light on tile changes, units and objects on it change light too
-		if (_unit != 0)
+		if (_store->unit[_index] != 0)
 		{
-			_unit->setCache(0);
+			_store->unit[_index]->setCache(0);
 		}
 	}
 }
@@ -412,7 +415,7 @@ void Tile::setDiscovered(bool flag, int part)
  */
 bool Tile::isDiscovered(int part) const
 {
-	return _discovered[part];
+	return (_store->discovered[_index] & (1 << part)) != 0;
 }
 
 
@@ -422,8 +425,7 @@ bool Tile::isDiscovered(int part) const
  */
 void Tile::resetLight(int layer)
 {
-	_light[layer] = 0;
-	_lastLight[layer] = _light[layer];
+	_store->light[layer][_index] = 0;
 }
 
 /**
@@ -433,8 +435,8 @@ void Tile::resetLight(int layer)
  */
 void Tile::addLight(int light, int layer)
 {
-	if (_light[layer] < light)
-		_light[layer] = light;
+	if (_store->light[layer][_index] < light)
+		_store->light[layer][_index] = light;
 }
 
 /**
@@ -448,8 +450,8 @@ int Tile::getShade() const
 
 	for (int layer = 0; layer < LIGHTLAYERS; layer++)
 	{
-		if (_light[layer] > light)
-			light = _light[layer];
+		if (_store->light[layer][_index] > light)
+			light = _store->light[layer][_index];
 	}
 
 	return std::max(0, 15 - light);
@@ -472,7 +474,7 @@ bool Tile::destroy(TilePart part, SpecialTileType type)
 			return false;
 		_objective = _objects[part]->getSpecialType() == type;
 		MapData *originalPart = _objects[part];
-		int originalMapDataSetID = _mapDataSetID[part];
+		int originalMapDataSetID = _store->mapDataSetID[_index * 4 + part];
 		setMapData(0, -1, -1, part);
 		if (originalPart->getDieMCD())
 		{
@@ -607,11 +609,12 @@ void Tile::ignite(int power)
 		}
 		if (RNG::percent(power) && getFuel())
 		{
-			if (_fire == 0)
+			if (_store->fire[_index] == 0)
 			{
-				_smoke = 15 - Clamp(getFlammability() / 10, 1, 12);
+				_store->smoke[_index] = 15 - Clamp(getFlammability() / 10, 1, 12);
 				_overlaps = 1;
-				_fire = getFuel() + 1;
+				_store->fire[_index] = getFuel() + 1;
+				_store->activate(_index);
 				_animationOffset = RNG::generate(0,3);
 			}
 		}
@@ -684,7 +687,11 @@ void Tile::setUnit(BattleUnit *unit, Tile *tileBelow)
 	{
 		unit->setTile(this, tileBelow);
 	}
-	_unit = unit;
+	if (_store->unit[_index] != unit)
+	{
+		_store->unit[_index] = unit;
+		++_store->changes;
+	}
 }
 
 /**
@@ -693,7 +700,11 @@ void Tile::setUnit(BattleUnit *unit, Tile *tileBelow)
  */
 void Tile::setFire(int fire)
 {
-	_fire = fire;
+	_store->fire[_index] = fire;
+	if (fire)
+	{
+		_store->activate(_index);
+	}
 	_animationOffset = RNG::generate(0,3);
 }
 
@@ -703,7 +714,7 @@ void Tile::setFire(int fire)
  */
 int Tile::getFire() const
 {
-	return _fire;
+	return _store->fire[_index];
 }
 
 /**
@@ -712,16 +723,17 @@ int Tile::getFire() const
  */
 void Tile::addSmoke(int smoke)
 {
-	if (_fire == 0)
+	if (_store->fire[_index] == 0)
 	{
 		if (_overlaps == 0)
 		{
-			_smoke = Clamp(_smoke + smoke, 1, 15);
+			_store->smoke[_index] = Clamp(_store->smoke[_index] + smoke, 1, 15);
 		}
 		else
 		{
-			_smoke += smoke;
+			_store->smoke[_index] += smoke;
 		}
+		_store->activate(_index);
 		_animationOffset = RNG::generate(0,3);
 		addOverlap();
 	}
@@ -733,7 +745,11 @@ void Tile::addSmoke(int smoke)
  */
 void Tile::setSmoke(int smoke)
 {
-	_smoke = smoke;
+	_store->smoke[_index] = smoke;
+	if (smoke)
+	{
+		_store->activate(_index);
+	}
 	_animationOffset = RNG::generate(0,3);
 }
 
@@ -744,7 +760,7 @@ void Tile::setSmoke(int smoke)
  */
 int Tile::getSmoke() const
 {
-	return _smoke;
+	return _store->smoke[_index];
 }
 
 /**
@@ -813,32 +829,33 @@ int Tile::getTopItemSprite()
 void Tile::prepareNewTurn(bool smokeDamage)
 {
 	// we've received new smoke in this turn, but we're not on fire, average out the smoke.
-	if ( _overlaps != 0 && _smoke != 0 && _fire == 0)
+	if ( _overlaps != 0 && _store->smoke[_index] != 0 && _store->fire[_index] == 0)
 	{
-		_smoke = Clamp((_smoke / _overlaps) - 1, 0, 15);
+		_store->smoke[_index] = Clamp((_store->smoke[_index] / _overlaps) - 1, 0, 15);
 	}
 	// if we still have smoke/fire
-	if (_smoke)
+	if (_store->smoke[_index])
 	{
-		if (_unit && !_unit->isOut())
+		BattleUnit *unit = _store->unit[_index];
+		if (unit && !unit->isOut())
 		{
-			if (_fire)
+			if (_store->fire[_index])
 			{
 				// this is how we avoid hitting the same unit multiple times.
-				if ((_unit->getArmor()->getSize() == 1 || !_unit->tookFireDamage())
+				if ((unit->getArmor()->getSize() == 1 || !unit->tookFireDamage())
 					//and avoid setting fire elementals on fire
-					&& _unit->getSpecialAbility() != SPECAB_BURNFLOOR && _unit->getSpecialAbility() != SPECAB_BURN_AND_EXPLODE)
+					&& unit->getSpecialAbility() != SPECAB_BURNFLOOR && unit->getSpecialAbility() != SPECAB_BURN_AND_EXPLODE)
 				{
-					_unit->toggleFireDamage();
-					// _smoke becomes our damage value
-					_unit->damage(Position(0, 0, 0), _smoke, DT_IN, true);
+					unit->toggleFireDamage();
+					// smoke becomes our damage value
+					unit->damage(Position(0, 0, 0), _store->smoke[_index], DT_IN, true);
 					// try to set the unit on fire.
-					if (RNG::percent(40 * _unit->getArmor()->getDamageModifier(DT_IN)))
+					if (RNG::percent(40 * unit->getArmor()->getDamageModifier(DT_IN)))
 					{
-						int burnTime = RNG::generate(0, int(5.0f * _unit->getArmor()->getDamageModifier(DT_IN)));
-						if (_unit->getFire() < burnTime)
+						int burnTime = RNG::generate(0, int(5.0f * unit->getArmor()->getDamageModifier(DT_IN)));
+						if (unit->getFire() < burnTime)
 						{
-							_unit->setFire(burnTime);
+							unit->setFire(burnTime);
 						}
 					}
 				}
@@ -849,9 +866,9 @@ void Tile::prepareNewTurn(bool smokeDamage)
 				if (smokeDamage)
 				{
 					// try to knock this guy out.
-					if (_unit->getArmor()->getDamageModifier(DT_SMOKE) > 0.0 && _unit->getArmor()->getSize() == 1)
+					if (unit->getArmor()->getDamageModifier(DT_SMOKE) > 0.0 && unit->getArmor()->getSize() == 1)
 					{
-						_unit->damage(Position(0,0,0), (_smoke / 4) + 1, DT_SMOKE, true);
+						unit->damage(Position(0,0,0), (_store->smoke[_index] / 4) + 1, DT_SMOKE, true);
 					}
 				}
 			}
@@ -894,7 +911,7 @@ int Tile::getMarkerColor() const
  */
 void Tile::setVisible(int visibility)
 {
-	_visible += visibility;
+	_store->visible[_index] += visibility;
 }
 
 /**
@@ -903,7 +920,7 @@ void Tile::setVisible(int visibility)
  */
 int Tile::getVisible() const
 {
-	return _visible;
+	return _store->visible[_index];
 }
 
 /**
@@ -965,6 +982,10 @@ void Tile::addOverlap()
 void Tile::setDangerous(bool danger)
 {
 	_danger = danger;
+	if (danger)
+	{
+		_store->markDangerous(_index);
+	}
 }
 
 /**
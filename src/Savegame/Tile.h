@@ -22,6 +22,7 @@
 #include "../Battlescape/Position.h"
 #include "../Mod/MapData.h"
 #include "BattleUnit.h"
+#include "TileStore.h"
 
 #include <SDL_types.h> // for Uint8
 
@@ -57,23 +58,17 @@ public:
 	static const int NOT_CALCULATED = -1;
 
 protected:
-	static const int LIGHTLAYERS = 3;
+	static const int LIGHTLAYERS = TileStore::LIGHT_LAYERS;
+	TileStore *_store;
+	int _index;
 	MapData *_objects[4];
-	int _mapDataID[4];
-	int _mapDataSetID[4];
 	int _currentFrame[4];
-	bool _discovered[3];
-	int _light[LIGHTLAYERS], _lastLight[LIGHTLAYERS];
-	int _smoke;
-	int _fire;
 	int _explosive;
 	int _explosiveType;
 	Position _pos;
-	BattleUnit *_unit;
 	std::vector<BattleItem *> _inventory;
 	int _animationOffset;
 	int _markerColor;
-	int _visible;
 	int _preview;
 	int _TUMarker;
 	int _overlaps;
@@ -82,7 +77,7 @@ protected:
 	int _obstacle;
 public:
 	/// Creates a tile.
-	Tile(Position pos);
+	Tile(Position pos, TileStore *store, int index);
 	/// Cleans up a tile.
 	~Tile();
 	/// Load the tile from yaml
@@ -179,7 +174,7 @@ public:
 	 */
 	BattleUnit *getUnit() const
 	{
-		return _unit;
+		return _store->unit[_index];
 	}
 	/// Set fire, does not increment overlaps.
 	void setFire(int fire);
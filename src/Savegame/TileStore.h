@@ -0,0 +1,131 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include <algorithm>
+#include <SDL_types.h>
+
+namespace OpenXcom
+{
+
+class BattleUnit;
+
+/**
+ * The frequently accessed per-tile values of a battle map, kept in contiguous arrays
+ * indexed like SavedBattleGame::getTileIndex() so map-wide sweeps (lighting, field
+ * of view, smoke and fire) don't have to visit every Tile object.
+ * Tile objects read and write their values here.
+ */
+struct TileStore
+{
+	static const int LIGHT_LAYERS = 3;
+	/// Words of terrain voxel data per tile: 12 layers of 16 rows of 16 voxels.
+	static const int VOXEL_WORDS = 12 * 16;
+	/// States of a tile's terrain voxel data.
+	enum VoxelState { VOXELS_DIRTY, VOXELS_EMPTY, VOXELS_FILLED };
+	/// Lists a tile can be on, see listed.
+	enum ListFlags { LISTED_ACTIVE = 1, LISTED_DANGEROUS = 2 };
+	/// MapData IDs and MapDataSet IDs, four parts per tile.
+	std::vector<int> mapDataID, mapDataSetID;
+	/// Light level of each tile, one array per layer: Ambient, Static and Dynamic.
+	std::vector<int> light[LIGHT_LAYERS];
+	std::vector<int> smoke, fire, visible;
+	/// Discovered flags of each tile, one bit per part: west wall, north wall, content and floor.
+	std::vector<Uint8> discovered;
+	std::vector<BattleUnit*> unit;
+	/// Terrain voxels of each tile, all parts combined, built by TileEngine when needed.
+	std::vector<Uint16> voxels;
+	/// Whether the terrain voxels of each tile are up to date, see VoxelState.
+	std::vector<Uint8> voxelState;
+	/// Tiles that have been burning or smoking, and tiles that have been marked dangerous, in no particular order.
+	std::vector<int> active, dangerous;
+	/// Which of those lists each tile is on, see ListFlags.
+	std::vector<Uint8> listed;
+	/// Counts changes to terrain voxels and unit occupancy, so results traced through the map can be cached.
+	unsigned int changes;
+
+	/// Creates an empty store.
+	TileStore() : changes(0)
+	{
+	}
+
+	/// Resizes the store for a number of tiles, resetting all the values.
+	void resize(int size)
+	{
+		mapDataID.assign(size * 4, -1);
+		mapDataSetID.assign(size * 4, -1);
+		for (int layer = 0; layer < LIGHT_LAYERS; ++layer)
+		{
+			light[layer].assign(size, 0);
+		}
+		smoke.assign(size, 0);
+		fire.assign(size, 0);
+		visible.assign(size, 0);
+		discovered.assign(size, 0);
+		unit.assign(size, 0);
+		voxels.assign(size * VOXEL_WORDS, 0);
+		voxelState.assign(size, VOXELS_DIRTY);
+		active.clear();
+		dangerous.clear();
+		listed.assign(size, 0);
+		++changes;
+	}
+
+	/// Adds a tile that started burning or smoking to the active tiles.
+	void activate(int index)
+	{
+		if (!(listed[index] & LISTED_ACTIVE))
+		{
+			listed[index] |= LISTED_ACTIVE;
+			active.push_back(index);
+		}
+	}
+
+	/// Adds a tile that was marked dangerous to the dangerous tiles.
+	void markDangerous(int index)
+	{
+		if (!(listed[index] & LISTED_DANGEROUS))
+		{
+			listed[index] |= LISTED_DANGEROUS;
+			dangerous.push_back(index);
+		}
+	}
+
+	/// Drops the active tiles that are neither burning nor smoking any more, and puts the rest in map order.
+	void sortActive()
+	{
+		size_t kept = 0;
+		for (size_t i = 0; i < active.size(); ++i)
+		{
+			int index = active[i];
+			if (fire[index] || smoke[index])
+			{
+				active[kept++] = index;
+			}
+			else
+			{
+				listed[index] &= ~LISTED_ACTIVE;
+			}
+		}
+		active.resize(kept);
+		std::sort(active.begin(), active.end());
+	}
+};
+
+}
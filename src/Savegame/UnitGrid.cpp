@@ -0,0 +1,155 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "UnitGrid.h"
+#include <algorithm>
+#include <cstdlib>
+#include "BattleUnit.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Initializes an empty unit grid.
+ */
+UnitGrid::UnitGrid() : _mapSizeX(0), _mapSizeY(0), _cellsX(0), _cellsY(0), _indexed(0)
+{
+}
+
+/**
+ * Cleans up the unit grid.
+ */
+UnitGrid::~UnitGrid()
+{
+}
+
+/**
+ * Gets the cell a map position falls into. Positions off the map
+ * (units that aren't placed yet) are clamped into the border cells.
+ * @param pos Map position.
+ * @return Cell index.
+ */
+int UnitGrid::getCell(Position pos) const
+{
+	int x = std::max(0, std::min(_cellsX - 1, pos.x / CELL_SIZE));
+	int y = std::max(0, std::min(_cellsY - 1, pos.y / CELL_SIZE));
+	return y * _cellsX + x;
+}
+
+/**
+ * Rebuilds the grid when the map has been resized or units have been
+ * added to the battle since the last update. Units are never removed from
+ * the battle, only knocked out, so a matching count means nothing changed.
+ * @param units The battle's units.
+ * @param mapSizeX Map width.
+ * @param mapSizeY Map length.
+ */
+void UnitGrid::update(const std::vector<BattleUnit*> &units, int mapSizeX, int mapSizeY)
+{
+	if (_indexed == units.size() && _mapSizeX == mapSizeX && _mapSizeY == mapSizeY)
+	{
+		return;
+	}
+	_mapSizeX = mapSizeX;
+	_mapSizeY = mapSizeY;
+	_cellsX = std::max(1, (mapSizeX + CELL_SIZE - 1) / CELL_SIZE);
+	_cellsY = std::max(1, (mapSizeY + CELL_SIZE - 1) / CELL_SIZE);
+	_cells.assign(_cellsX * _cellsY, std::vector<Entry>());
+	for (size_t i = 0; i < units.size(); ++i)
+	{
+		// cells are filled in unit order, so every cell stays sorted.
+		_cells[getCell(units[i]->getPosition())].push_back(Entry((int)i, units[i]));
+		units[i]->setUnitGrid(this);
+	}
+	_indexed = units.size();
+}
+
+/**
+ * Moves a unit from the cell of its old position to the cell of its
+ * current one, keeping the cell sorted by unit order.
+ * @param unit The unit that moved.
+ * @param from The unit's previous position.
+ */
+void UnitGrid::moveUnit(BattleUnit *unit, Position from)
+{
+	int oldCell = getCell(from);
+	int newCell = getCell(unit->getPosition());
+	if (oldCell == newCell)
+	{
+		return;
+	}
+	std::vector<Entry> &src = _cells[oldCell];
+	for (std::vector<Entry>::iterator i = src.begin(); i != src.end(); ++i)
+	{
+		if (i->second == unit)
+		{
+			Entry entry = *i;
+			src.erase(i);
+			std::vector<Entry> &dst = _cells[newCell];
+			dst.insert(std::upper_bound(dst.begin(), dst.end(), entry), entry);
+			return;
+		}
+	}
+}
+
+/**
+ * Gets the live units whose position is within a square radius of
+ * a position, in the same order as the battle's unit list so callers
+ * behave exactly as if they had walked the whole list.
+ * Callers still apply their own exact distance check.
+ * @param pos Center of the query.
+ * @param radius Radius of the query, in tiles.
+ * @param units Vector to fill with the units found.
+ * @param ignoreFaction Faction to leave out, or -1 for none.
+ */
+void UnitGrid::getUnits(Position pos, int radius, std::vector<BattleUnit*> &units, int ignoreFaction) const
+{
+	units.clear();
+	if (_cells.empty())
+	{
+		return;
+	}
+	int minCell = getCell(Position(pos.x - radius, pos.y - radius, 0));
+	int maxCell = getCell(Position(pos.x + radius, pos.y + radius, 0));
+	std::vector<Entry> found;
+	for (int y = minCell / _cellsX; y <= maxCell / _cellsX; ++y)
+	{
+		for (int x = minCell % _cellsX; x <= maxCell % _cellsX; ++x)
+		{
+			const std::vector<Entry> &cell = _cells[y * _cellsX + x];
+			for (std::vector<Entry>::const_iterator i = cell.begin(); i != cell.end(); ++i)
+			{
+				BattleUnit *unit = i->second;
+				if (unit->isOut() || unit->getFaction() == ignoreFaction)
+					continue;
+				Position p = unit->getPosition();
+				if (std::abs(p.x - pos.x) <= radius && std::abs(p.y - pos.y) <= radius)
+				{
+					found.push_back(*i);
+				}
+			}
+		}
+	}
+	std::sort(found.begin(), found.end());
+	for (std::vector<Entry>::const_iterator i = found.begin(); i != found.end(); ++i)
+	{
+		units.push_back(i->second);
+	}
+}
+
+}
@@ -0,0 +1,60 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include <utility>
+#include "../Battlescape/Position.h"
+
+namespace OpenXcom
+{
+
+class BattleUnit;
+
+/**
+ * A uniform grid of the battle units, bucketed by map position, so range
+ * queries (spotting, reaction fire, explosion assessment) only look at the
+ * units in the cells they overlap instead of every unit on the map.
+ * Units report their moves to the grid; units added to the battle are picked
+ * up the next time the grid is updated.
+ */
+class UnitGrid
+{
+private:
+	/// Size of a grid cell, in tiles.
+	static const int CELL_SIZE = 8;
+	typedef std::pair<int, BattleUnit*> Entry;
+	int _mapSizeX, _mapSizeY, _cellsX, _cellsY;
+	size_t _indexed;
+	std::vector< std::vector<Entry> > _cells;
+	/// Gets the cell index of a map position, clamped to the grid.
+	int getCell(Position pos) const;
+public:
+	/// Creates an empty unit grid.
+	UnitGrid();
+	/// Cleans up the unit grid.
+	~UnitGrid();
+	/// Rebuilds the grid if the map size or the unit list has changed.
+	void update(const std::vector<BattleUnit*> &units, int mapSizeX, int mapSizeY);
+	/// Moves a unit to the cell of its new position.
+	void moveUnit(BattleUnit *unit, Position from);
+	/// Gets the live units around a position.
+	void getUnits(Position pos, int radius, std::vector<BattleUnit*> &units, int ignoreFaction = -1) const;
+};
+
+}